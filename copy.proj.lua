@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "copy"
+    kind      "ConsoleApp"
+    files     { "utests/copy/*", "utests/common/*.h", "utests/common/*.cpp", "include/*.h", "include/*.inl" }
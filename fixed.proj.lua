@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "fixed"
+    kind      "ConsoleApp"
+    files     { "utests/fixed/*", "utests/common/*.h", "utests/common/*.cpp", "include/*.h", "include/*.inl" }
@@ -0,0 +1,73 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+#pragma once
+
+// C++
+
+#include <cstdint>
+#include <cstring>
+
+// intrinsics
+
+#include <immintrin.h>
+#if _WIN32
+#    include <intrin.h>
+#else
+#    include <cpuid.h>
+#endif
+
+// preprocessor
+
+#if _WIN32
+#    define QCS_NOINLINE __declspec(noinline)
+#    define QCS_TARGET_AVX2
+#else
+#    define QCS_NOINLINE    __attribute__((noinline))
+#    define QCS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace qcstudio::memops {
+
+    /*
+        copy kernels used by the transactions
+
+        size classes:
+        ● up to `SMALL_MAX` bytes: inline overlapping moves (no call, no loop)
+        ● up to `AVX2_MAX` bytes: AVX2 unrolled loop (plain `memcpy` if the cpu has no AVX2)
+        ● up to `STREAM_MIN` bytes: plain `memcpy` (`rep movsb` beats the AVX2 loop there)
+        ● from `STREAM_MIN` bytes: non-temporal (streaming) stores, so big payloads do not evict
+          the working set of the other side from the shared cache (`copy` only, into the storage: `copy_out` goes
+          on with `memcpy`, the reader is about to use what it copies)
+
+        notes:
+        ● `copy` is inlined into the transactions and only the small class with it: the others are a single
+          out-of-line call (`copy_large`), hence a constant small size is a couple of moves
+        ● AVX2 is detected once (CPUID + XGETBV) on first use
+        ● streaming copies end with a store fence, hence they are visible before the index is published
+        ● source and destination must not overlap
+    */
+
+    constexpr auto SMALL_MAX  = uint64_t{64};
+    constexpr auto AVX2_MAX   = uint64_t{2 * 1024};
+    constexpr auto STREAM_MIN = uint64_t{256 * 1024};
+
+    void copy(void* _dst, const void* _src, uint64_t _size);      // into the storage (writes)
+    void copy_out(void* _dst, const void* _src, uint64_t _size);  // out of the storage (reads), never streams
+
+    // kernels (exposed for benchmarking; `copy_small` up to `SMALL_MAX` bytes, the rest more than 32 bytes)
+
+    void copy_large(uint8_t* _dst, const uint8_t* _src, uint64_t _size, bool _stream);  // the size classes above `SMALL_MAX`
+
+    void copy_small(uint8_t* _dst, const uint8_t* _src, uint64_t _size);
+    void copy_avx2(uint8_t* _dst, const uint8_t* _src, uint64_t _size);
+    void copy_stream_avx2(uint8_t* _dst, const uint8_t* _src, uint64_t _size);
+    void copy_stream_sse2(uint8_t* _dst, const uint8_t* _src, uint64_t _size);
+
+    // cpu features
+
+    auto detect_avx2() -> bool;
+    auto has_avx2() -> bool;
+
+}  // namespace qcstudio::memops
+
+#include "tx-copy.inl"
@@ -0,0 +1,263 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+#pragma push_macro("QCS_INLINE")
+#undef QCS_INLINE
+#if _WIN32
+#    define QCS_INLINE __forceinline  // __declspec(noinline) inline || __forceinline
+#else
+#    define QCS_INLINE inline __attribute__((always_inline))
+#endif
+
+/*
+    ========
+    Dispatch
+    ========
+*/
+
+QCS_INLINE void qcstudio::memops::copy(void* _dst, const void* _src, uint64_t _size) {
+    auto dst = (uint8_t*)_dst;
+    auto src = (const uint8_t*)_src;
+
+    if (_size <= SMALL_MAX) {
+        copy_small(dst, src, _size);
+    } else {
+        copy_large(dst, src, _size, true);
+    }
+}
+
+QCS_INLINE void qcstudio::memops::copy_out(void* _dst, const void* _src, uint64_t _size) {
+    auto dst = (uint8_t*)_dst;
+    auto src = (const uint8_t*)_src;
+
+    if (_size <= SMALL_MAX) {
+        copy_small(dst, src, _size);
+    } else {
+        copy_large(dst, src, _size, false);
+    }
+}
+
+QCS_NOINLINE inline void qcstudio::memops::copy_large(uint8_t* _dst, const uint8_t* _src, uint64_t _size, bool _stream) {
+    auto dst = _dst;
+    auto src = _src;
+
+    if (_size <= AVX2_MAX && has_avx2()) {
+        copy_avx2(dst, src, _size);
+    } else if (_size < STREAM_MIN || !_stream) {
+        memcpy(dst, src, _size);
+    } else if (has_avx2()) {
+        copy_stream_avx2(dst, src, _size);
+    } else {
+        copy_stream_sse2(dst, src, _size);
+    }
+}
+
+/*
+    =======
+    Kernels
+    =======
+*/
+
+// inlined with a known size, GCC still checks the size classes it does not reach against the object (false positives)
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Warray-bounds"
+#    pragma GCC diagnostic ignored "-Wstringop-overflow"
+#    pragma GCC diagnostic ignored "-Wstringop-overread"
+#    pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+QCS_INLINE void qcstudio::memops::copy_small(uint8_t* _dst, const uint8_t* _src, uint64_t _size) {
+    // load both ends (they may overlap) before storing
+
+    if (_size >= 32) {
+        auto a = _mm_loadu_si128((const __m128i*)_src);
+        auto b = _mm_loadu_si128((const __m128i*)(_src + 16));
+        auto c = _mm_loadu_si128((const __m128i*)(_src + _size - 32));
+        auto d = _mm_loadu_si128((const __m128i*)(_src + _size - 16));
+        _mm_storeu_si128((__m128i*)_dst, a);
+        _mm_storeu_si128((__m128i*)(_dst + 16), b);
+        _mm_storeu_si128((__m128i*)(_dst + _size - 32), c);
+        _mm_storeu_si128((__m128i*)(_dst + _size - 16), d);
+    } else if (_size >= 16) {
+        auto a = _mm_loadu_si128((const __m128i*)_src);
+        auto b = _mm_loadu_si128((const __m128i*)(_src + _size - 16));
+        _mm_storeu_si128((__m128i*)_dst, a);
+        _mm_storeu_si128((__m128i*)(_dst + _size - 16), b);
+    } else if (_size >= 8) {
+        uint64_t a, b;
+        memcpy(&a, _src, 8);
+        memcpy(&b, _src + _size - 8, 8);
+        memcpy(_dst, &a, 8);
+        memcpy(_dst + _size - 8, &b, 8);
+    } else if (_size >= 4) {
+        uint32_t a, b;
+        memcpy(&a, _src, 4);
+        memcpy(&b, _src + _size - 4, 4);
+        memcpy(_dst, &a, 4);
+        memcpy(_dst + _size - 4, &b, 4);
+    } else if (_size >= 2) {
+        uint16_t a, b;
+        memcpy(&a, _src, 2);
+        memcpy(&b, _src + _size - 2, 2);
+        memcpy(_dst, &a, 2);
+        memcpy(_dst + _size - 2, &b, 2);
+    } else if (_size == 1) {
+        *_dst = *_src;
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#endif
+
+QCS_NOINLINE QCS_TARGET_AVX2 inline void qcstudio::memops::copy_avx2(uint8_t* _dst, const uint8_t* _src, uint64_t _size) {
+    // the last 32 bytes are stored at the end (overlapping), hence the loops never deal with a remainder
+
+    const auto last     = _mm256_loadu_si256((const __m256i*)(_src + _size - 32));
+    const auto last_dst = _dst + _size - 32;
+
+    while (_size > 128) {
+        auto a = _mm256_loadu_si256((const __m256i*)_src);
+        auto b = _mm256_loadu_si256((const __m256i*)(_src + 32));
+        auto c = _mm256_loadu_si256((const __m256i*)(_src + 64));
+        auto d = _mm256_loadu_si256((const __m256i*)(_src + 96));
+        _mm256_storeu_si256((__m256i*)_dst, a);
+        _mm256_storeu_si256((__m256i*)(_dst + 32), b);
+        _mm256_storeu_si256((__m256i*)(_dst + 64), c);
+        _mm256_storeu_si256((__m256i*)(_dst + 96), d);
+        _src += 128;
+        _dst += 128;
+        _size -= 128;
+    }
+
+    while (_size > 32) {
+        _mm256_storeu_si256((__m256i*)_dst, _mm256_loadu_si256((const __m256i*)_src));
+        _src += 32;
+        _dst += 32;
+        _size -= 32;
+    }
+
+    _mm256_storeu_si256((__m256i*)last_dst, last);
+}
+
+QCS_NOINLINE QCS_TARGET_AVX2 inline void qcstudio::memops::copy_stream_avx2(uint8_t* _dst, const uint8_t* _src, uint64_t _size) {
+    // unaligned head so that the streaming stores are 32-byte aligned
+
+    const auto last     = _mm256_loadu_si256((const __m256i*)(_src + _size - 32));
+    const auto last_dst = _dst + _size - 32;
+    const auto head     = (32 - ((uintptr_t)_dst & 31)) & 31;
+    _mm256_storeu_si256((__m256i*)_dst, _mm256_loadu_si256((const __m256i*)_src));
+    _src += head;
+    _dst += head;
+    _size -= head;
+
+    while (_size >= 128) {
+        auto a = _mm256_loadu_si256((const __m256i*)_src);
+        auto b = _mm256_loadu_si256((const __m256i*)(_src + 32));
+        auto c = _mm256_loadu_si256((const __m256i*)(_src + 64));
+        auto d = _mm256_loadu_si256((const __m256i*)(_src + 96));
+        _mm256_stream_si256((__m256i*)_dst, a);
+        _mm256_stream_si256((__m256i*)(_dst + 32), b);
+        _mm256_stream_si256((__m256i*)(_dst + 64), c);
+        _mm256_stream_si256((__m256i*)(_dst + 96), d);
+        _src += 128;
+        _dst += 128;
+        _size -= 128;
+    }
+
+    while (_size >= 32) {
+        _mm256_stream_si256((__m256i*)_dst, _mm256_loadu_si256((const __m256i*)_src));
+        _src += 32;
+        _dst += 32;
+        _size -= 32;
+    }
+
+    _mm_sfence();  // streaming stores are weakly ordered
+    _mm256_storeu_si256((__m256i*)last_dst, last);
+}
+
+QCS_NOINLINE inline void qcstudio::memops::copy_stream_sse2(uint8_t* _dst, const uint8_t* _src, uint64_t _size) {
+    // unaligned head so that the streaming stores are 16-byte aligned
+
+    const auto last     = _mm_loadu_si128((const __m128i*)(_src + _size - 16));
+    const auto last_dst = _dst + _size - 16;
+    const auto head     = (16 - ((uintptr_t)_dst & 15)) & 15;
+    _mm_storeu_si128((__m128i*)_dst, _mm_loadu_si128((const __m128i*)_src));
+    _src += head;
+    _dst += head;
+    _size -= head;
+
+    while (_size >= 64) {
+        auto a = _mm_loadu_si128((const __m128i*)_src);
+        auto b = _mm_loadu_si128((const __m128i*)(_src + 16));
+        auto c = _mm_loadu_si128((const __m128i*)(_src + 32));
+        auto d = _mm_loadu_si128((const __m128i*)(_src + 48));
+        _mm_stream_si128((__m128i*)_dst, a);
+        _mm_stream_si128((__m128i*)(_dst + 16), b);
+        _mm_stream_si128((__m128i*)(_dst + 32), c);
+        _mm_stream_si128((__m128i*)(_dst + 48), d);
+        _src += 64;
+        _dst += 64;
+        _size -= 64;
+    }
+
+    while (_size >= 16) {
+        _mm_stream_si128((__m128i*)_dst, _mm_loadu_si128((const __m128i*)_src));
+        _src += 16;
+        _dst += 16;
+        _size -= 16;
+    }
+
+    _mm_sfence();  // streaming stores are weakly ordered
+    _mm_storeu_si128((__m128i*)last_dst, last);
+}
+
+/*
+    ============
+    CPU features
+    ============
+*/
+
+QCS_NOINLINE inline auto qcstudio::memops::detect_avx2() -> bool {
+    // cpu support (leaf 1: OSXSAVE + AVX, leaf 7: AVX2) and os support (XCR0: SSE + AVX state)
+
+#if _WIN32
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if ((regs[2] & (1 << 27)) == 0 || (regs[2] & (1 << 28)) == 0) {
+        return false;
+    }
+    if ((_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    if ((ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0) {
+        return false;
+    }
+    unsigned xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 6) != 6) {
+        return false;
+    }
+    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+    return (ebx & bit_AVX2) != 0;
+#endif
+}
+
+QCS_INLINE auto qcstudio::memops::has_avx2() -> bool {
+    static const auto result = detect_avx2();
+    return result;
+}
+
+#pragma pop_macro("QCS_INLINE")
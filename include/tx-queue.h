@@ -4,36 +4,92 @@
 
 // C++
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <new>
+#include <optional>
+#include <span>
 #include <tuple>
 #include <string>
 #include <type_traits>
 #include <thread>
+#include <vector>
+
+// intrinsics
+
+#include <immintrin.h>
 
 // windows
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
+#if _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <Windows.h>
+
+#    pragma comment(lib, "onecore.lib")        // VirtualAlloc2 / MapViewOfFile3
+#    pragma comment(lib, "Synchronization.lib")  // WaitOnAddress / WakeByAddressAll
+#endif
+
+// linux
+
+#if !_WIN32
+#    include <linux/futex.h>
+#    include <linux/mempolicy.h>
+#    include <sched.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    if __has_include(<sys/rseq.h>)
+#        include <sys/rseq.h>  // glibc 2.35+ registers an rseq area for every thread
+#        define QCS_HAS_RSEQ 1
+#    endif
+#endif
 
 // preprocessor
 
-#pragma warning(push)
-#pragma warning(disable : 4324 4625 5026 4626 5027)
+#if _WIN32
+#    pragma warning(push)
+#    pragma warning(disable : 4324 4625 5026 4626 5027)
+#endif
+
+// qcstudio
+
+#include "tx-copy.h"
 
-#define QCS_DECLARE_QUEUE_FRIENDS \
-    template<typename QTYPE>      \
-    friend class tx_write_t;      \
-    template<typename QTYPE>      \
-    friend class tx_read_t;
+#define QCS_DECLARE_QUEUE_FRIENDS                                                                            \
+    template<typename QTYPE>                                                                                 \
+    friend class tx_write_t;                                                                                 \
+    template<typename QTYPE>                                                                                 \
+    friend class tx_read_t;                                                                                  \
+    template<typename QTYPE>                                                                                 \
+    friend class tx_producer_t;                                                                              \
+    template<typename QTYPE>                                                                                 \
+    friend class tx_consumer_t;                                                                              \
+    template<typename QTYPE>                                                                                 \
+    friend auto write_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline) -> bool;                  \
+    template<typename QTYPE>                                                                                 \
+    friend auto read_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline) -> bool;                   \
+    template<typename QTYPE>                                                                                 \
+    friend auto read_wait(QTYPE& _queue, uint32_t _reader, uint64_t _size, tx_deadline_t _deadline) -> bool; \
+    template<uint32_t LANES, typename LANE_WAIT>                                                             \
+    friend class tx_lane_set_t;
 
 namespace qcstudio {
 
     using namespace std;
 
-    constexpr auto CACHE_LINE_SIZE = std::hardware_destructive_interference_size;
+    constexpr auto CACHE_LINE_SIZE = size_t{64};  // fixed, it is part of the layout shared between processes and builds
+    constexpr auto NUMA_MAX_NODES  = 1024;        // bits of the node masks passed to the kernel
+
+    using tx_deadline_t = chrono::steady_clock::time_point;
 
     /*
         `tx-queue-XX` are a high-performance, transaction-based, SPSC and SP/MP queues.
@@ -43,57 +99,1101 @@ namespace qcstudio {
         ● `tx-queue-mp` for queues shared between two processed
 
         notes:
-        * capacity must be power of 2
+        * any capacity: the indices are 64-bit cursors that only grow (no wrap around), hence every byte is usable
         * memory provided must be initialized (zeroed) and cache-line aligned
     */
 
+    /*
+        blocking helpers
+
+        wait (according to the queue wait strategy) until `_size` bytes can be written/read or the deadline expires.
+        then, a transaction of up to `_size` bytes will succeed (single producer/consumer)
+    */
+
+    template<typename QTYPE>
+    auto write_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
+    template<typename QTYPE>
+    auto read_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
+    template<typename QTYPE>
+    auto read_wait(QTYPE& _queue, uint32_t _reader, uint64_t _size, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;  // broadcast queues
+
+    /*
+        storage modes
+
+        ● `HEAP`       plain aligned allocation; records crossing the end of the storage are split
+        ● `MIRRORED`   the storage pages are mapped twice, back to back, so every record is contiguous
+                       (capacity is rounded up to a multiple of the allocation granularity)
+        ● `INLINE`     inside the queue object, next to its status lines (only fixed-capacity queues)
+        ● `HUGE_PAGES` huge pages (2 MiB), so big rings do not miss the dTLB; falls back to transparent huge pages
+                       (linux) or regular pages when they are not available, `pages()` tells which backing it got
+                       (the allocation is rounded up to the huge page size, the capacity is not)
+    */
+
+    enum class tx_storage_t : uint8_t {
+        HEAP,
+        MIRRORED,
+        INLINE,
+        HUGE_PAGES
+    };
+
+    /*
+        pages backing the storage
+
+        ● `REGULAR`          the default pages of the system (4 KiB)
+        ● `EXPLICIT_HUGE`    reserved huge pages (`MAP_HUGETLB`/`MEM_LARGE_PAGES`)
+        ● `TRANSPARENT_HUGE` regular pages advised to be merged into huge pages (`madvise`), the kernel does it
+                             when it can
+    */
+
+    enum class tx_pages_t : uint8_t {
+        REGULAR,
+        EXPLICIT_HUGE,
+        TRANSPARENT_HUGE
+    };
+
+    /*
+        numa placement of the storage pages (linux, raw `mbind` so no libnuma; first touch on windows and on
+        single-node machines)
+
+        ● `first_touch()` (default) the pages land on the node of the thread that writes them first (the producer)
+        ● `consumer()`    bound to the node of the consumer, resolved by its first read transaction or session
+                          (the pages touched so far are moved)
+        ● `node_of(n)`    bound to node `n`
+        ● `interleave()`  spread over all the nodes, page by page
+
+        notes:
+        ● only the pages that lie entirely within the storage are placed (small queues may share theirs)
+        ● the status lines are not placed: they share one page (and live in the caches of both sides anyway)
+        ● `numa()` of a queue tells the placement it got (`first_touch()` if it could not be applied)
+    */
+
+    struct tx_numa_t {
+        enum class policy_t : uint8_t {
+            FIRST_TOUCH,
+            CONSUMER,
+            NODE,
+            INTERLEAVE
+        };
+
+        policy_t policy = policy_t::FIRST_TOUCH;
+        int32_t  node   = -1;
+
+        static constexpr auto first_touch() -> tx_numa_t;
+        static constexpr auto consumer() -> tx_numa_t;
+        static constexpr auto node_of(int32_t _node) -> tx_numa_t;
+        static constexpr auto interleave() -> tx_numa_t;
+    };
+
     class base_tx_queue_t {
     public:
         auto     is_ok() const -> bool;
         auto     capacity() const -> uint64_t;
+        auto     storage() const -> tx_storage_t;
+        auto     pages() const -> tx_pages_t;
+        auto     numa() const -> tx_numa_t;
+        auto     place(tx_numa_t _numa) -> bool;  // (re)place the storage pages now, `consumer()` waits for its first read (any time, even with transactions running)
         explicit operator bool() const noexcept;
 
     protected:
         alignas(CACHE_LINE_SIZE) uint8_t* storage_ = nullptr;
-        uint64_t capacity_                         = 0;
+        uint64_t     capacity_                     = 0;
+        tx_storage_t storage_type_                 = tx_storage_t::HEAP;
+        tx_pages_t   pages_                        = tx_pages_t::REGULAR;
+        tx_numa_t    numa_;
         QCS_DECLARE_QUEUE_FRIENDS
+
+        void imp_allocate(uint64_t _capacity, tx_storage_t _storage);                        // single-process: own the storage
+        void imp_release();                                                                  //
+        void imp_attach(uint8_t* _storage, uint64_t _capacity, tx_storage_t _storage_type);  // multi-process: validate the caller's storage
+        void imp_place_on_consumer();                                                        // first read of the consumer (`tx_numa_t::consumer()`)
+        void imp_store_numa(tx_numa_t _numa);                                                // atomic stores, see `imp_place_on_consumer`
+    };
+
+    /*
+        eventcount used to sleep/wake one side of the queue
+
+        notes:
+        ● the sleeper registers itself, re-checks and sleeps only if `epoch_` did not move
+        ● the other side bumps `epoch_` and wakes only if there are sleepers
+        ● no initializers: it lives in the status of multi-process queues, which the attaching process constructs
+          again while the other one may be asleep on it (a fresh segment is zeroed, single-process queues zero it)
+    */
+
+    struct tx_wait_word_t {
+        uint32_t epoch_;
+        uint32_t sleepers_;
+    };
+
+    /*
+        layout of the status lines of `tx_queue_sp_t`/`tx_queue_mpsc_t`/`tx_queue_mp_t`
+
+        ● `tx_layout_compact_t`  one line per side (its index and core), transactions load the index of the other
+                                 side as they start
+        ● `tx_layout_shadow_t`   (default) the same lines plus a shadow of the other side's index in each one:
+                                 transactions start from it and only load the remote index when it runs short
+        ● `tx_layout_padded_t`   shadows, and every line padded to 128 bytes so the adjacent-line prefetcher does not
+                                 drag the line of the other side along
+
+        notes:
+        ● every line is written by one side only (the wait words aside, only used by `tx_wait_futex_t`)
+        ● a shadow stays between the real index and a lap behind it, hence it is always safe to start from
+        ● multi-process queues: both processes must agree on the layout (`status_t` of the queue tells the size)
+          and the memory must be aligned to `line_size`
+        ● fixed-capacity queues and lanes use the default
+    */
+
+    struct tx_layout_compact_t {
+        static constexpr auto line_size = CACHE_LINE_SIZE;
+        static constexpr auto shadows   = false;
+    };
+
+    struct tx_layout_shadow_t {
+        static constexpr auto line_size = CACHE_LINE_SIZE;
+        static constexpr auto shadows   = true;
+    };
+
+    struct tx_layout_padded_t {
+        static constexpr auto line_size = 2 * CACHE_LINE_SIZE;
+        static constexpr auto shadows   = true;
+    };
+
+    /*
+        transaction counters of `tx_queue_sp_t`/`tx_queue_mpsc_t`/`tx_queue_mp_t`, compiled in by the stats policy
+
+        ● `tx_stats_off_t` (default) no counters: neither code nor lines
+        ● `tx_stats_on_t`  one more line per side in the status, written by that side only (producers of
+                           `tx_queue_mpsc_t` share theirs, hence add atomically)
+        ● `tx_stats_latency_t` the counters plus the enqueue-to-dequeue latency of every message, see below
+
+        counters of a side:
+        ● `committed`/`invalidated` transactions as they end, `bytes` committed (sessions included: counted by
+          their transactions, not on flush)
+        ● `syncs`  loads of the index of the other side (no space/data left from the cached one)
+        ● `wraps`  copies split around the end of the storage (never on mirrored storage)
+        ● `yields` times the core was yielded because the other side was on the same core
+        ● `high_water` the highest occupancy (bytes) seen as this side synced the index of the other one
+
+        notes:
+        ● multi-process queues: both processes must agree on the policy (the counters live in the status, so any of
+          them can read both sides, and so can a monitor, see `tx_monitor_t`)
+        ● `stats()` reads them relaxed (every counter is exact, the set is not a snapshot); all zero when off
+    */
+
+    struct tx_counters_t {
+        uint64_t committed;
+        uint64_t invalidated;
+        uint64_t bytes;
+        uint64_t syncs;
+        uint64_t wraps;
+        uint64_t yields;
+        uint64_t high_water;
+
+        auto load() const -> tx_counters_t;  // relaxed copy
+    };
+
+    struct tx_stats_t {
+        tx_counters_t producer;
+        tx_counters_t consumer;
+    };
+
+    struct tx_latency_t {
+        uint64_t count;
+        double   p50, p99, p999, max;  // nanoseconds
+    };
+
+    /*
+        latency histogram (HDR-style): every power of 2 is split in `SUB_BUCKETS` linear buckets, hence any value is
+        kept within ~6% (exact below 32 ticks)
+
+        notes:
+        ● one writer (`record`), any number of lock-free readers (relaxed, as the counters)
+        ● values are TSC ticks, `tx_latency_t` has them in nanoseconds
+        ● lives in shared memory for multi-process queues, hence no constructor (zeroed memory is empty)
+    */
+
+    class tx_histogram_t {
+    public:
+        static constexpr auto SUB_BITS    = 4u;
+        static constexpr auto SUB_BUCKETS = 1u << SUB_BITS;
+        static constexpr auto BUCKETS     = (64u - SUB_BITS - 1u) * SUB_BUCKETS + 2u * SUB_BUCKETS;
+
+        void record(uint64_t _ticks);
+        auto count() const -> uint64_t;
+        auto max() const -> uint64_t;
+        auto percentile(double _percentile) const -> uint64_t;  // ticks, `_percentile` in [0, 100] (an upper bound)
+        auto summary() const -> tx_latency_t;
+
+    private:
+        uint64_t max_;
+        uint64_t buckets_[BUCKETS];
+
+        static constexpr auto imp_bucket(uint64_t _ticks) -> uint32_t;
+        static constexpr auto imp_highest(uint32_t _bucket) -> uint64_t;  // highest value of a bucket
+    };
+
+    /*
+        latency mode (`tx_stats_latency_t`)
+
+        ● `tx_write_t` puts an 8 byte stamp in front of every transaction and fills it with the TSC upon commit
+        ● `tx_read_t` consumes the stamp as it starts and records now - stamp upon commit in the histogram of the
+          consumer (its lines, after its counters)
+
+        notes:
+        ● every transaction becomes a record: read transactions must consume whole write transactions, one each
+        ● empty write transactions are not published, `bytes` does not count the stamps
+        ● multi-producer queues: the stamp is part of the reservation, `tx_write_t(queue, size)` takes the payload size
+        ● the TSC must be invariant (synchronized between cores), as on any x86 of the last decade
+    */
+
+    /*
+        first line of the counters: where a monitor finds the rest (written once, by `tx_queue_mp_t`)
+
+        notes:
+        ● offsets are from the start of the status, `latency_offset` is 0 without histogram
+        ● `magic` is written last (release), a monitor ignores the block until it matches
+    */
+
+    struct tx_stats_header_t {
+        static constexpr auto MAGIC   = uint64_t{0x3173'7461'7473'7874};  // "txstats1"
+        static constexpr auto VERSION = 1u;
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t line_size;
+        uint64_t capacity;
+        uint32_t tail_offset, head_offset;
+        uint32_t producer_offset, consumer_offset;
+        uint32_t latency_offset;
     };
 
-    struct tx_queue_status_t {
+    struct tx_stats_off_t {
+        static constexpr auto enabled = false;
+        static constexpr auto latency = false;
+
+        template<size_t LINE_SIZE>
+        struct lines_t {};
+    };
+
+    struct tx_stats_on_t {
+        static constexpr auto enabled = true;
+        static constexpr auto latency = false;
+
+        template<size_t LINE_SIZE>
+        struct lines_t {
+            alignas(LINE_SIZE) tx_stats_header_t header_;
+            alignas(LINE_SIZE) tx_counters_t producer_;  // producer line
+            alignas(LINE_SIZE) tx_counters_t consumer_;  // consumer line
+        };
+    };
+
+    struct tx_stats_latency_t {
+        static constexpr auto enabled = true;
+        static constexpr auto latency = true;
+
+        template<size_t LINE_SIZE>
+        struct lines_t {
+            alignas(LINE_SIZE) tx_stats_header_t header_;
+            alignas(LINE_SIZE) tx_counters_t producer_;  // producer line
+            alignas(LINE_SIZE) tx_counters_t consumer_;  // consumer lines
+            tx_histogram_t latency_;
+        };
+    };
+
+    template<typename LAYOUT, typename STATS = tx_stats_off_t>
+    struct basic_tx_queue_status_t {
+        alignas(LAYOUT::line_size) uint64_t tail_;  // producer line
+        uint64_t cached_head_;                      // shadow of `head_`
+        int32_t  producer_core_;
+        uint32_t stats_offset_;                     // of `tx_stats_header_t` (0: none), the same place in every layout
+        alignas(LAYOUT::line_size) uint64_t head_;  // consumer line
+        uint64_t cached_tail_;                      // shadow of `tail_`
+        int32_t  consumer_core_;
+        alignas(LAYOUT::line_size) tx_wait_word_t data_ready_;  // consumer sleeps here (only `tx_wait_futex_t`)
+        tx_wait_word_t space_ready_;                            // producer sleeps here (only `tx_wait_futex_t`)
+
+        // transaction counters (empty when off, then it fits in the line above)
+
+        typename STATS::template lines_t<LAYOUT::line_size> stats_;
+
+        // what transactions see of the consumer side (`_reader` is only meaningful on broadcast queues)
+
+        auto slowest_head(uint64_t _tail, memory_order _order) -> uint64_t;
+        auto consumer_on_core(int32_t _core) -> bool;
+        auto reader_head(uint32_t _reader) -> uint64_t&;
+        auto reader_core(uint32_t _reader) -> int32_t&;
+        auto stats() const -> tx_stats_t;
+        auto latency() const -> tx_latency_t;
+        void describe(uint64_t _capacity);  // fill `tx_stats_header_t` (if any) for monitors
+    };
+
+    using tx_queue_status_t = basic_tx_queue_status_t<tx_layout_shadow_t, tx_stats_off_t>;
+
+    /*
+        indices of broadcast queues: one head per reader, each on its own cache line
+
+        notes:
+        ● the free space of the producer is set by the slowest reader
+    */
+
+    struct alignas(CACHE_LINE_SIZE) tx_reader_status_t {
+        uint64_t head_;
+        int32_t  consumer_core_;
+    };
+
+    template<uint32_t READERS>
+    struct tx_broadcast_status_t {
+        alignas(CACHE_LINE_SIZE) uint64_t tail_;
+        int32_t producer_core_;
+        alignas(CACHE_LINE_SIZE) tx_wait_word_t data_ready_;  // readers sleep here (only `tx_wait_futex_t`)
+        tx_wait_word_t     space_ready_;                      // producer sleeps here (only `tx_wait_futex_t`)
+        tx_reader_status_t readers_[READERS];
+
+        auto slowest_head(uint64_t _tail, memory_order _order) -> uint64_t;
+        auto consumer_on_core(int32_t _core) -> bool;
+        auto reader_head(uint32_t _reader) -> uint64_t&;
+        auto reader_core(uint32_t _reader) -> int32_t&;
+    };
+
+    /*
+        indices of work queues
+
+        notes:
+        ● `claim_` is the end of the claimed records, consumers race on it (a cursor, so no ABA on the CAS)
+        ● `head_` is the end of the reclaimed (finished) records, only moved by the producer
+        ● consumers wait on `claim_` (`reader_head`), the producer on `head_` (`slowest_head`)
+    */
+
+    struct tx_work_status_t {
         alignas(CACHE_LINE_SIZE) uint64_t tail_;
-        int32_t producer_core_ = -1;
+        int32_t producer_core_;
+        alignas(CACHE_LINE_SIZE) uint64_t claim_;
+        uint64_t released_;  // records given back that were not claimed again
+        int32_t  consumer_core_;
         alignas(CACHE_LINE_SIZE) uint64_t head_;
-        int32_t consumer_core_ = -1;
+        alignas(CACHE_LINE_SIZE) tx_wait_word_t data_ready_;  // consumers sleep here (only `tx_wait_futex_t`)
+        tx_wait_word_t space_ready_;                          // producer sleeps here (only `tx_wait_futex_t`)
+
+        auto slowest_head(uint64_t _tail, memory_order _order) -> uint64_t;
+        auto consumer_on_core(int32_t _core) -> bool;
+        auto reader_head(uint32_t _reader) -> uint64_t&;
+        auto reader_core(uint32_t _reader) -> int32_t&;
     };
 
+    /*
+        wait strategies (how `write_wait`/`read_wait` wait while the queue is full/empty)
+
+        ● `tx_wait_spin_t`  busy-spin with `pause`
+        ● `tx_wait_yield_t` spin a while, then yield the core
+        ● `tx_wait_futex_t` spin a while, then sleep until the other side commits (also across processes)
+
+        notes:
+        ● only `tx_wait_futex_t` adds work to the commit path (a load of the sleepers counter)
+        ● `_ready` is re-evaluated after every spin/yield/wake up
+    */
+
+    struct tx_wait_spin_t {
+        template<typename READY>
+        static auto wait(tx_wait_word_t& _word, bool _shared, tx_deadline_t _deadline, READY&& _ready) -> bool;
+        static void notify(tx_wait_word_t& _word, bool _shared);
+    };
+
+    struct tx_wait_yield_t {
+        static constexpr auto SPINS = 256u;
+
+        template<typename READY>
+        static auto wait(tx_wait_word_t& _word, bool _shared, tx_deadline_t _deadline, READY&& _ready) -> bool;
+        static void notify(tx_wait_word_t& _word, bool _shared);
+    };
+
+    struct tx_wait_futex_t {
+        static constexpr auto SPINS = 1024u;
+
+        template<typename READY>
+        static auto wait(tx_wait_word_t& _word, bool _shared, tx_deadline_t _deadline, READY&& _ready) -> bool;
+        static void notify(tx_wait_word_t& _word, bool _shared);
+    };
+
+    /*
+        futex helpers
+
+        notes:
+        ● linux: FUTEX_WAIT/FUTEX_WAKE (private unless shared between processes)
+        ● windows: WaitOnAddress/WakeByAddressAll, which do not cross processes, hence shared sleepers
+          sleep in short slices and re-check
+    */
+
+    namespace futex {
+        void wait(uint32_t* _address, uint32_t _expected, bool _shared, tx_deadline_t _deadline);
+        void wake_all(uint32_t* _address, bool _shared);
+    }  // namespace futex
+
+    /*
+        time stamp counter
+
+        notes:
+        ● `ticks_per_ns` is calibrated once (~10 ms against the steady clock), on first use
+    */
+
+    namespace tsc {
+        auto now() -> uint64_t;
+        auto ticks_per_ns() -> double;
+    }  // namespace tsc
+
+    /*
+        core the calling thread runs on, for the same-core detection of full/empty transactions (they yield when the
+        other side is on it)
+
+        ● windows: `GetCurrentProcessorNumber` (no kernel transition)
+        ● linux: the `cpu_id` the kernel keeps up to date in the rseq area of the thread (a plain load), `sched_getcpu`
+          (vDSO) when rseq is not registered (glibc < 2.35, or disabled with `glibc.pthread.rseq=0`)
+
+        notes:
+        ● never -1, the mark of a side that is not waiting (-2 if unknown)
+    */
+
+    namespace cpu {
+        auto current() -> int32_t;
+    }  // namespace cpu
+
     /*
         single-process transaction queue
     */
 
+    template<typename WAIT = tx_wait_yield_t, typename LAYOUT = tx_layout_shadow_t, typename STATS = tx_stats_off_t>
     class tx_queue_sp_t : public base_tx_queue_t {
     public:
-        tx_queue_sp_t(uint64_t _capacity);
+        using wait_t                            = WAIT;
+        using status_t                          = basic_tx_queue_status_t<LAYOUT, STATS>;
+        static constexpr auto is_shared         = false;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = false;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = LAYOUT::shadows;
+        static constexpr auto has_stats         = STATS::enabled;
+        static constexpr auto has_latency       = STATS::latency;
+        static constexpr auto fixed_capacity    = uint64_t{0};
+        static constexpr auto STAMP_SIZE        = uint64_t{has_latency ? 8 : 0};  // latency mode: the TSC in front of every record
+
+        tx_queue_sp_t(uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
         ~tx_queue_sp_t();
 
+        auto stats() const -> tx_stats_t;
+        auto latency() const -> tx_latency_t;
+
     private:
-        tx_queue_status_t status_;
+        status_t status_;
+        QCS_DECLARE_QUEUE_FRIENDS
+    };
+
+    /*
+        single-process transaction queue, several producers (threads) and one consumer
+
+        notes:
+        ● producers reserve the whole transaction up front, `tx_write_t(queue, size)`, racing on `reserve_`
+        ● every reservation is a record: an 8 byte header (size and state) is put in front of it and its end is
+          padded to 8 bytes (the capacity is rounded up to 8 bytes too, so headers never wrap around)
+        ● reservations are published in order and the consumer reads them with plain `tx_read_t`, one record per
+          transaction (committing consumes the whole record)
+        ● a slow producer holds back the ones that reserved after it (they wait to publish)
+        ● an invalidated (or not completely written) reservation is rolled back if it is the last one, otherwise it
+          is published as skipped and the consumer steps over it
+        ● the size takes 32 bits of the header: bigger reservations fail (`MAX_RECORD_SIZE`, the stamp included)
+        ● no producer sessions
+    */
+
+    template<typename WAIT = tx_wait_yield_t, typename LAYOUT = tx_layout_shadow_t, typename STATS = tx_stats_off_t>
+    class tx_queue_mpsc_t : public tx_queue_sp_t<WAIT, LAYOUT, STATS> {
+    public:
+        static constexpr auto is_multi_producer = true;
+        static constexpr auto MAX_RECORD_SIZE   = uint64_t{UINT32_MAX};  // bytes of one reservation
+
+        tx_queue_mpsc_t(uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+
+    private:
+        static constexpr auto HEADER_SIZE = uint64_t{8};
+
+        enum class state_t : uint32_t {  // magic values, as in the work queue
+            PUBLISHED = 0x7852'0001,
+            SKIPPED   = 0x7852'0002  // invalidated or incomplete, followed by other reservations
+        };
+
+        alignas(CACHE_LINE_SIZE) uint64_t reserve_ = 0;  // end of the last reservation (a cursor, so no ABA on the CAS)
         QCS_DECLARE_QUEUE_FRIENDS
+
+        auto imp_header(uint64_t _position) -> uint64_t&;
+        static auto imp_pack(uint64_t _size, state_t _state) -> uint64_t;
+        static auto imp_padded(uint64_t _size) -> uint64_t;
     };
 
+    /*
+        single-process work queue, one producer and several consumers (threads), every record is read by one of them
+
+        notes:
+        ● every write transaction is a record: an 8 byte header (size and state) is put in front of it and its end
+          is padded to 8 bytes (the capacity is rounded up to 8 bytes too, so headers never wrap around)
+        ● the size takes 32 bits of the header: a write that would grow a record past `MAX_RECORD_SIZE` invalidates
+          the transaction
+        ● a read transaction claims the next whole record (CAS on `claim_`) and can only read within it
+        ● commit = done: the producer reclaims the space of the finished records, in order
+        ● invalidate = release the claim: the record goes back to the queue for the next consumer
+        ● a slow consumer holds back the reclaim of the records claimed after it
+        ● no sessions
+    */
+
+    template<typename WAIT = tx_wait_yield_t>
+    class tx_queue_spmc_t : public base_tx_queue_t {
+    public:
+        using wait_t                            = WAIT;
+        static constexpr auto is_shared         = false;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = false;
+        static constexpr auto is_work_queue     = true;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = false;
+        static constexpr auto has_stats         = false;
+        static constexpr auto has_latency       = false;
+        static constexpr auto fixed_capacity    = uint64_t{0};
+
+        static constexpr auto MAX_RECORD_SIZE = uint64_t{UINT32_MAX};  // payload bytes of one record
+
+        tx_queue_spmc_t(uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+        ~tx_queue_spmc_t();
+
+    private:
+        static constexpr auto HEADER_SIZE = uint64_t{8};
+
+        enum class state_t : uint32_t {  // magic values, the header of a stale position would not match by chance
+            PUBLISHED = 0x7851'0001,
+            CLAIMED   = 0x7851'0002,
+            RELEASED  = 0x7851'0003,
+            DONE      = 0x7851'0004
+        };
+
+        tx_work_status_t status_;
+        QCS_DECLARE_QUEUE_FRIENDS
+
+        auto imp_header(uint64_t _position) -> uint64_t&;
+        void imp_reclaim();
+        static auto imp_pack(uint64_t _size, state_t _state) -> uint64_t;
+        static auto imp_padded(uint64_t _size) -> uint64_t;
+    };
+
+    /*
+        lane of a `tx_lane_set_t`: a single-process queue that flags itself in the readiness bitmap of the set
+        when a commit is published
+    */
+
+    template<typename WAIT = tx_wait_yield_t>
+    class tx_lane_t : public tx_queue_sp_t<WAIT> {
+    public:
+        static constexpr auto is_lane = true;
+
+        tx_lane_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa, uint64_t* _ready, uint64_t _bit, tx_wait_word_t* _ready_word);
+
+    private:
+        uint64_t*       ready_;       // word of the readiness bitmap
+        uint64_t        bit_;         // our bit in it
+        tx_wait_word_t* ready_word_;  // the consumer of the set sleeps here (only `tx_wait_futex_t`)
+        QCS_DECLARE_QUEUE_FRIENDS
+
+        void imp_signal();
+    };
+
+    /*
+        many producers (threads) and one consumer, every producer thread gets its own lane (a SPSC queue)
+
+        notes:
+        ● `lane()` hands out the lane of the calling thread, registered (thread-local) on first use
+        ● producers use plain transactions or sessions on their lane: `tx_write_t(set.lane())`
+        ● a commit flags the lane in a readiness bitmap, `drain` only visits the flagged lanes (round-robin, up to
+          `_budget` transactions each), hence idle lanes cost nothing to the consumer
+        ● the handler of `drain` reads one message from the transaction, an invalidated one ends the lane for this round
+        ● `leave()` gives the lane of the calling thread back (its pending data is still delivered, flush its session first),
+          and so does the exit of the thread (its registrations are a thread-local object)
+        ● once all the lanes are taken, `lane()` hands out an invalid lane: `!set.lane()` tells, and its transactions fail
+        ● lanes are allocated on first use, all of them with `_lane_capacity`
+        ● the flag is checked after every published commit, behind a full fence
+    */
+
+    template<uint32_t LANES = 64, typename WAIT = tx_wait_yield_t>
+    class tx_lane_set_t {
+    public:
+        using lane_t                = tx_lane_t<WAIT>;
+        using wait_t                = WAIT;
+        static constexpr auto lanes = LANES;
+
+        tx_lane_set_t(uint64_t _lane_capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+        explicit operator bool() const noexcept;
+
+        // producers
+
+        auto lane() -> lane_t&;
+        void leave();
+
+        // consumer
+
+        template<typename HANDLER>
+        auto drain(HANDLER&& _handler, uint64_t _budget = 16) -> uint64_t;
+
+    private:
+        static constexpr auto WORDS = (LANES + 63) / 64;
+
+        struct alignas(CACHE_LINE_SIZE) taken_t {
+            uint64_t words[WORDS] = {};  // lanes with an owner thread
+        };
+
+        struct registration_t {
+            uint64_t            set;    // `id_` of the set
+            uint32_t            lane;   // index of the lane
+            shared_ptr<taken_t> taken;  // shared, so that a thread outliving the set can still give its lane back
+        };
+
+        struct registrations_t : vector<registration_t> {  // of the calling thread, its lanes are given back on exit
+            ~registrations_t();
+        };
+
+        template<uint32_t L, typename W>
+        friend auto read_wait(tx_lane_set_t<L, W>& _set, tx_deadline_t _deadline) -> bool;
+
+        alignas(CACHE_LINE_SIZE) uint64_t ready_[WORDS] = {};  // lanes with (maybe) data, set by producers and cleared by the consumer
+        alignas(CACHE_LINE_SIZE) tx_wait_word_t ready_word_ = {};
+        shared_ptr<taken_t>              taken_;
+        uint64_t                         id_;          // key of the thread-local registrations (never reused)
+        uint64_t                         lane_capacity_;
+        tx_storage_t                     storage_;
+        tx_numa_t                        numa_;        // of every lane
+        array<unique_ptr<lane_t>, LANES> lanes_;
+        lane_t                           none_;        // handed out once all the lanes are taken
+        uint32_t                         cursor_ = 0;  // the last lane drained
+
+        static auto imp_registrations() -> registrations_t&;
+        static void imp_release(const registration_t& _registration);
+        static constexpr auto imp_valid_bits(uint32_t _word) -> uint64_t;
+        template<typename HANDLER>
+        auto imp_drain_lane(uint32_t _lane, HANDLER& _handler, uint64_t _budget) -> uint64_t;
+    };
+
+    // blocking helper on lane sets: wait until a lane is flagged
+
+    template<uint32_t LANES, typename WAIT>
+    auto read_wait(tx_lane_set_t<LANES, WAIT>& _set, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
+    /*
+        single-process object queue: a ring of `SLOTS` slots of `T`, one producer and one consumer (threads)
+
+        notes:
+        ● objects are constructed in place (`emplace`), moved out (`pop`) and destroyed, hence any movable `T` works
+          (`unique_ptr`, `string`, ...), unlike the byte queues which copy bytes
+        ● `SLOTS` must be a power of 2, the slot of an index is computed at compile time (indices are not wrapped,
+          so all the slots are used)
+        ● the slots live inside the object, allocate big queues on the heap
+        ● the objects left in the queue are destroyed with it
+    */
+
+    template<typename T, uint64_t SLOTS, typename WAIT = tx_wait_yield_t>
+    class tx_object_queue_t {
+    public:
+        using wait_t                = WAIT;
+        using value_t               = T;
+        static constexpr auto slots = SLOTS;
+
+        tx_object_queue_t() = default;
+        ~tx_object_queue_t();
+
+        // producer (false if full)
+
+        template<typename... ARGS>
+        auto emplace(ARGS&&... _args) -> bool;
+
+        // consumer (empty/false if empty)
+
+        auto pop() -> optional<T>;
+        auto pop(T& _item) -> bool;
+
+    private:
+        static_assert(SLOTS >= 2 && (SLOTS & (SLOTS - 1)) == 0, "the number of slots must be a power of 2");
+
+        static constexpr auto MASK = SLOTS - 1;
+
+        template<typename Q, uint64_t S, typename W>
+        friend auto write_wait(tx_object_queue_t<Q, S, W>& _queue, tx_deadline_t _deadline) -> bool;
+        template<typename Q, uint64_t S, typename W>
+        friend auto read_wait(tx_object_queue_t<Q, S, W>& _queue, tx_deadline_t _deadline) -> bool;
+
+        alignas(CACHE_LINE_SIZE) uint64_t tail_ = 0;  // next slot to construct (producer)
+        uint64_t cached_head_   = 0;
+        int32_t  producer_core_ = -1;
+        alignas(CACHE_LINE_SIZE) uint64_t head_ = 0;  // next slot to move out (consumer)
+        uint64_t cached_tail_   = 0;
+        int32_t  consumer_core_ = -1;
+        alignas(CACHE_LINE_SIZE) tx_wait_word_t data_ready_ = {};  // consumer sleeps here (only `tx_wait_futex_t`)
+        tx_wait_word_t space_ready_                         = {};  // producer sleeps here (only `tx_wait_futex_t`)
+        alignas(CACHE_LINE_SIZE) alignas(T) uint8_t slots_[SLOTS][sizeof(T)];
+
+        static constexpr auto imp_index(uint64_t _index) -> uint64_t;
+        auto imp_slot(uint64_t _index) -> T*;
+        template<typename TAKE>
+        auto imp_pop(TAKE&& _take) -> bool;
+    };
+
+    // blocking helpers on object queues: wait until one object can be emplaced/popped
+
+    template<typename T, uint64_t SLOTS, typename WAIT>
+    auto write_wait(tx_object_queue_t<T, SLOTS, WAIT>& _queue, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
+    template<typename T, uint64_t SLOTS, typename WAIT>
+    auto read_wait(tx_object_queue_t<T, SLOTS, WAIT>& _queue, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
     /*
         multi-process transaction queue
+
+        notes:
+        ● `MIRRORED` means the caller already mapped the storage that follows the status twice (see `shared_memory`)
+        ● `HUGE_PAGES` means the caller already backed the storage with explicit huge pages (see `shared_memory`)
+        ● both processes must use the same wait strategy
     */
 
+    template<typename WAIT = tx_wait_yield_t, typename LAYOUT = tx_layout_shadow_t, typename STATS = tx_stats_off_t>
     class tx_queue_mp_t : public base_tx_queue_t {
     public:
-        tx_queue_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity);
+        using wait_t                            = WAIT;
+        using status_t                          = basic_tx_queue_status_t<LAYOUT, STATS>;
+        static constexpr auto is_shared         = true;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = false;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = LAYOUT::shadows;
+        static constexpr auto has_stats         = STATS::enabled;
+        static constexpr auto has_latency       = STATS::latency;
+        static constexpr auto fixed_capacity    = uint64_t{0};
+        static constexpr auto STAMP_SIZE        = uint64_t{has_latency ? 8 : 0};  // latency mode: the TSC in front of every record
+
+        tx_queue_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+
+        auto stats() const -> tx_stats_t;
+        auto latency() const -> tx_latency_t;
+
+    private:
+        QCS_DECLARE_QUEUE_FRIENDS
+        status_t& status_;
+    };
+
+    /*
+        read-only view of a `tx_queue_mp_t` built with counters (`tx_stats_on_t`/`tx_stats_latency_t`), from any
+        process that maps its memory (even read-only), without knowing its layout or policy
+
+        ● `sample()` loads the cursors, the counters of both sides and the latency summary (if any)
+        ● rates and stalls come from two samples: bytes/s from `bytes`, and a side is stalled when it has work
+          (the consumer: data pending; the producer: never, it may just be idle) and its cursor did not move
+
+        notes:
+        ● invalid (`operator bool`) until the queue has been constructed on the memory, or if it has no counters
+        ● loads only: a monitor never writes to the status, and it only pulls the lines it reads
+    */
+
+    struct tx_sample_t {
+        uint64_t     tail, head;  // occupancy = tail - head
+        tx_stats_t   stats;
+        tx_latency_t latency;  // all zero without histogram
+    };
+
+    class tx_monitor_t {
+    public:
+        explicit tx_monitor_t(const uint8_t* _memory);  // what the queue was given (`_prealloc_and_init`)
+        explicit operator bool() const noexcept;
+
+        auto capacity() const -> uint64_t;
+        auto has_latency() const -> bool;
+        auto sample() const -> tx_sample_t;
+
+    private:
+        const uint8_t*           memory_ = nullptr;
+        const tx_stats_header_t* header_ = nullptr;
+    };
+
+    /*
+        fixed-capacity queues: `CAPACITY` is a compile-time constant, hence transactions and sessions fold every mask
+        and bound. Same behavior as `tx_queue_sp_t`/`tx_queue_mp_t` otherwise
+
+        notes:
+        ● `CAPACITY` must be at least one cache line (checked at compile time); a power of 2 turns the cursor to
+          position conversion into a mask, any other value into a multiplication
+        ● `tx_storage_t::INLINE` (default) puts the storage inside the queue, right after its status lines, so the
+          whole queue is one allocation; meant for small queues (or allocate the queue itself on the heap)
+        ● `tx_storage_t::MIRRORED` needs `CAPACITY` to be a multiple of the allocation granularity, otherwise the
+          queue is invalid
+        ● the multi-process version expects `memory_size` bytes: the status followed by the storage
+    */
+
+    template<uint64_t CAPACITY, tx_storage_t STORAGE = tx_storage_t::INLINE, typename WAIT = tx_wait_yield_t>
+    class tx_queue_sp_fixed_t : public base_tx_queue_t {
+    public:
+        using wait_t                            = WAIT;
+        static constexpr auto is_shared         = false;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = false;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = tx_layout_shadow_t::shadows;
+        static constexpr auto has_stats         = false;
+        static constexpr auto has_latency       = false;
+        static constexpr auto fixed_capacity    = CAPACITY;
+
+        tx_queue_sp_fixed_t(tx_numa_t _numa = {});
+        ~tx_queue_sp_fixed_t();
 
     private:
+        static_assert(CAPACITY >= CACHE_LINE_SIZE, "the capacity must be at least one cache line");
+
+        tx_queue_status_t status_;
+        alignas(CACHE_LINE_SIZE) uint8_t inline_[STORAGE == tx_storage_t::INLINE ? CAPACITY : 1];
+        QCS_DECLARE_QUEUE_FRIENDS
+    };
+
+    template<uint64_t CAPACITY, typename WAIT = tx_wait_yield_t>
+    class tx_queue_mp_fixed_t : public base_tx_queue_t {
+    public:
+        using wait_t                            = WAIT;
+        static constexpr auto is_shared         = true;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = false;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = tx_layout_shadow_t::shadows;
+        static constexpr auto has_stats         = false;
+        static constexpr auto has_latency       = false;
+        static constexpr auto fixed_capacity    = CAPACITY;
+        static constexpr auto memory_size       = sizeof(tx_queue_status_t) + CAPACITY;
+
+        tx_queue_mp_fixed_t(uint8_t* _prealloc_and_init, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+
+    private:
+        static_assert(CAPACITY >= CACHE_LINE_SIZE, "the capacity must be at least one cache line");
 
         QCS_DECLARE_QUEUE_FRIENDS
         tx_queue_status_t& status_;
     };
 
+    /*
+        broadcast queues: one producer and `READERS` consumers, every consumer reads every message
+
+        notes:
+        ● consumers identify themselves, `tx_read_t(queue, reader)` and `read_wait(queue, reader, size)`, with
+          `reader < READERS` (otherwise the transaction is invalidated and `read_wait` fails)
+        ● all the readers are active from the start; one that stops reading blocks the producer once the ring is full
+        ● no consumer sessions
+        ● the multi-process version expects `sizeof(tx_broadcast_status_t<READERS>)` bytes before the storage
+    */
+
+    template<uint32_t READERS, typename WAIT = tx_wait_yield_t>
+    class tx_broadcast_sp_t : public base_tx_queue_t {
+    public:
+        using wait_t                            = WAIT;
+        static constexpr auto is_shared         = false;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = true;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = false;
+        static constexpr auto has_stats         = false;
+        static constexpr auto has_latency       = false;
+        static constexpr auto fixed_capacity    = uint64_t{0};
+        static constexpr auto readers           = READERS;
+
+        tx_broadcast_sp_t(uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+        ~tx_broadcast_sp_t();
+
+    private:
+        tx_broadcast_status_t<READERS> status_;
+        QCS_DECLARE_QUEUE_FRIENDS
+    };
+
+    template<uint32_t READERS, typename WAIT = tx_wait_yield_t>
+    class tx_broadcast_mp_t : public base_tx_queue_t {
+    public:
+        using wait_t                            = WAIT;
+        static constexpr auto is_shared         = true;
+        static constexpr auto is_multi_producer = false;
+        static constexpr auto is_broadcast      = true;
+        static constexpr auto is_work_queue     = false;
+        static constexpr auto is_lane           = false;
+        static constexpr auto has_shadows       = false;
+        static constexpr auto has_stats         = false;
+        static constexpr auto has_latency       = false;
+        static constexpr auto fixed_capacity    = uint64_t{0};
+        static constexpr auto readers           = READERS;
+
+        tx_broadcast_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity, tx_storage_t _storage = tx_storage_t::HEAP, tx_numa_t _numa = {});
+
+    private:
+        QCS_DECLARE_QUEUE_FRIENDS
+        tx_broadcast_status_t<READERS>& status_;
+    };
+
+    /*
+        virtual memory helpers
+
+        notes:
+        ● `map_mirrored` maps the same physical pages twice, back to back: [0, size) and [size, 2 * size)
+        ● sizes must be multiple of `allocation_granularity()`
+        ● `map_huge` tries explicit huge pages, then transparent ones (linux) and regular ones, `_pages` tells which
+          one it got; sizes must be multiple of `huge_page_size()`
+        ● `enable_huge_pages` enables the "lock pages in memory" privilege once (windows, the account must hold it)
+        ● `numa_nodes` is 1 on single-node machines (and where placement is not supported), `current_node` is the
+          node of the calling thread, `place` applies a placement to the pages entirely within a range
+    */
+
+    namespace vmem {
+        auto allocation_granularity() -> uint64_t;
+        auto map_mirrored(uint64_t _size) -> uint8_t*;
+        void unmap_mirrored(uint8_t* _address, uint64_t _size);
+        auto huge_page_size() -> uint64_t;
+        auto enable_huge_pages() -> bool;
+        auto map_huge(uint64_t _size, tx_pages_t& _pages) -> uint8_t*;
+        void unmap_huge(uint8_t* _address, uint64_t _size);
+        auto numa_nodes() -> uint32_t;
+        auto current_node() -> int32_t;
+        auto place(uint8_t* _address, uint64_t _size, tx_numa_t _numa) -> bool;
+    }  // namespace vmem
+
+    /*
+        packed record layout of a variadic write/read
+
+        notes:
+        ● fields are laid out back to back, no padding (same bytes as writing them one by one)
+        ● `packed` tells if the whole pack can be moved with a single space check and copy
+          (every field trivially copyable and neither a pointer nor an array)
+    */
+
+    template<typename... ARGS>
+    struct tx_record_t {
+        static constexpr auto packed = (true && ... && (is_trivially_copyable_v<ARGS> && !is_pointer_v<ARGS> && !is_array_v<ARGS>));
+        static constexpr auto size   = (uint64_t{0} + ... + sizeof(ARGS));
+
+        static constexpr auto offsets = []() {
+            auto result = array<uint64_t, sizeof...(ARGS)>{};
+            auto offset = uint64_t{0}, i = uint64_t{0};
+            ((result[i++] = offset, offset += sizeof(ARGS)), ...);
+            return result;
+        }();
+    };
+
+    /*
+        zero-copy view into the queue storage
+
+        notes:
+        ● `second` is only non-empty when the region wraps around the end of the storage (never on mirrored storage)
+    */
+
+    template<typename T>
+    struct tx_span_t {
+        span<T> first, second;
+
+        auto size() const -> uint64_t;
+        auto empty() const -> bool;
+    };
+
+    /*
+        position in the storage of a cursor (head, tail, claim, ...)
+
+        notes:
+        ● cursors only grow, a 64-bit one does not wrap around in practice
+        ● power of 2 capacities are masked, the rest pay a division (a multiplication on fixed-capacity queues)
+    */
+
+    constexpr auto tx_offset(uint64_t _cursor, uint64_t _capacity) -> uint64_t;
+
+    /*
+        capacity as seen by transactions and sessions: a copy of the queue one, or a constant for fixed-capacity
+        queues (assigning it does nothing, every mask and bound is then folded by the compiler)
+    */
+
+    template<uint64_t CAPACITY>
+    struct tx_fixed_capacity_t {
+        constexpr operator uint64_t() const noexcept { return CAPACITY; }
+        constexpr auto operator=(uint64_t) noexcept -> tx_fixed_capacity_t& { return *this; }
+    };
+
+    template<typename QTYPE>
+    using tx_capacity_t = conditional_t<QTYPE::fixed_capacity != 0, tx_fixed_capacity_t<QTYPE::fixed_capacity>, uint64_t>;
+
+    /*
+        producer/consumer sessions (batched publication)
+
+        transactions started from a session commit into it and the shared index is only published:
+        ● explicitly, with `flush()`
+        ● automatically, every `_max_messages` transactions or `_max_bytes` bytes (0 = no limit)
+        ● when a transaction fails (so the other side can make progress) and upon destruction
+
+        sessions are long-lived: they keep their own index, the cached index of the other side and the
+        queue constants across transactions, hence transactions started from them do not touch the
+        status lines until they run out of space (producer) or data (consumer)
+
+        notes:
+        ● the other side only sees flushed data (producer) or space (consumer)
+        ● one session per side; do not mix it with plain transactions on the same side
+    */
+
+    template<typename QTYPE>
+    class tx_producer_t {
+    public:
+        tx_producer_t(QTYPE& _queue, uint64_t _max_messages = 0, uint64_t _max_bytes = 0);
+        ~tx_producer_t();
+
+        void flush();
+        auto queue() -> QTYPE&;
+
+    private:
+        template<typename Q>
+        friend class tx_write_t;
+
+        QTYPE&               queue_;
+        uint8_t*             storage_;
+        uint64_t             tail_, cached_head_, max_messages_, max_bytes_;
+        tx_capacity_t<QTYPE> capacity_;
+        uint64_t             pending_messages_ = 0, pending_bytes_ = 0;
+        bool                 ok_ : 1;
+        bool                 mirrored_ : 1;
+
+        void imp_commit(uint64_t _tail, uint64_t _cached_head);
+    };
+
+    template<typename QTYPE>
+    class tx_consumer_t {
+    public:
+        tx_consumer_t(QTYPE& _queue, uint64_t _max_messages = 0, uint64_t _max_bytes = 0);
+        ~tx_consumer_t();
+
+        void flush();
+        auto queue() -> QTYPE&;
+
+    private:
+        template<typename Q>
+        friend class tx_read_t;
+
+        QTYPE&               queue_;
+        uint8_t*             storage_;
+        uint64_t             head_, cached_tail_, max_messages_, max_bytes_;
+        tx_capacity_t<QTYPE> capacity_;
+        uint64_t             pending_messages_ = 0, pending_bytes_ = 0;
+        bool                 ok_ : 1;
+        bool                 mirrored_ : 1;
+
+        void imp_commit(uint64_t _head, uint64_t _cached_tail);
+    };
+
+    // blocking helpers on sessions (flush first, then wait)
+
+    template<typename QTYPE>
+    auto write_wait(tx_producer_t<QTYPE>& _producer, uint64_t _size, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
+    template<typename QTYPE>
+    auto read_wait(tx_consumer_t<QTYPE>& _consumer, uint64_t _size, tx_deadline_t _deadline = tx_deadline_t::max()) -> bool;
+
     /*
         write transaction
 
@@ -101,12 +1201,17 @@ namespace qcstudio {
         ● size = 1 cache line
         ● auto-invalidates if a write fails
         ● keep queue constants locally here (storage and capacity)
+        ● multi-producer queues: reserve `_size` bytes up front and write exactly that (`cached_head_` is then the end of the reservation)
+        ● work queues: the record header sits at `reservation_`
+        ● other queues: `reservation_` is where the transaction started (bytes of the stats, the stamp in latency mode)
     */
 
     template<typename QTYPE>
     class alignas(CACHE_LINE_SIZE) tx_write_t {
     public:
         tx_write_t(QTYPE& _queue);
+        tx_write_t(QTYPE& _queue, uint64_t _size);
+        tx_write_t(tx_producer_t<QTYPE>& _producer);
         ~tx_write_t();
         explicit operator bool() const noexcept;
 
@@ -115,20 +1220,38 @@ namespace qcstudio {
                                                    auto write(const void* _buffer, uint64_t _size) -> bool;                                   // a raw buffer
         template<typename T>                       auto write(const T& _item) -> bool;                                                        // a normal type
         template<typename T, uint64_t N>           auto write(const T (&_array)[N]) -> bool;                                                  // an array (no trailing '\0' for character arrays)
-        template<typename FIRST, typename... REST> auto write(const FIRST& _first, REST... _rest) -> enable_if_t<!is_pointer_v<FIRST>, bool>; // variadic
+        template<typename FIRST, typename... REST> auto write(const FIRST& _first, REST... _rest) -> enable_if_t<!is_pointer_v<FIRST>, bool>; // variadic (one check and copy if `tx_record_t` is packed)
         // clang-format on
 
+        // zero-copy: reserve room to be filled in place (published upon commit like any other write)
+
+        auto reserve(uint64_t _size) -> tx_span_t<uint8_t>;
+
         // invalidate and won't auto-commit
 
         void invalidate();
 
     private:
-        QTYPE&   queue_;
-        uint8_t* storage_;
-        uint64_t tail_, cached_head_, capacity_;
-        bool     invalidated_ : 1;
+        static constexpr auto STAMP_SIZE = uint64_t{QTYPE::has_latency ? 8 : 0};
+
+        QTYPE&                queue_;
+        tx_producer_t<QTYPE>* producer_ = nullptr;
+        uint8_t*              storage_;
+        uint64_t              tail_, cached_head_, reservation_;
+        tx_capacity_t<QTYPE>  capacity_;
+        bool                  invalidated_ : 1;
+        bool                  mirrored_ : 1;
 
         auto imp_write(const void* _buffer, uint64_t _size) -> bool;
+        template<typename... ARGS>
+        auto imp_write_packed(const ARGS&... _args) -> bool;
+        auto imp_check_space(uint64_t _size) -> bool;
+        void imp_advance(uint64_t _size);
+        void imp_publish_in_order();
+        void imp_publish_record();
+        void imp_count(uint64_t tx_counters_t::*_counter, uint64_t _value);
+        void imp_peak(uint64_t _occupancy);
+        void imp_stamp();
     };
 
     /*
@@ -138,12 +1261,17 @@ namespace qcstudio {
         ● size = 1 cache line
         ● auto-invalidates if a read fails
         ● keep queue constants locally here (storage and capacity)
+        ● work queues: the claimed record (header) sits at `record_` and `cached_tail_` is its end
+        ● multi-producer queues: `record_` is right after the header of the record, which bounds the reads (its size)
+        ● other queues: `record_` is where the transaction started (bytes of the stats, the stamp in latency mode)
     */
 
     template<typename QTYPE>
     class alignas(CACHE_LINE_SIZE) tx_read_t {
     public:
         tx_read_t(QTYPE& _queue);
+        tx_read_t(QTYPE& _queue, uint32_t _reader);  // broadcast queues
+        tx_read_t(tx_consumer_t<QTYPE>& _consumer);
         ~tx_read_t();
         explicit operator bool() const noexcept;
 
@@ -151,25 +1279,51 @@ namespace qcstudio {
         // clang-format off
                                   auto read(void* _buffer, uint64_t _size) -> bool;                                             // a buffer
         template<typename T>      auto read(T& _item) -> bool;                                                                  // an individual type
-        template<typename...ARGS> auto read() -> enable_if_t<conjunction_v<is_default_constructible<ARGS>...>, tuple<ARGS...>>; // structured-bindings compatible
+        template<typename...ARGS> auto read() -> enable_if_t<conjunction_v<is_default_constructible<ARGS>...>, tuple<ARGS...>>; // structured-bindings compatible (one check and copy if `tx_record_t` is packed)
 
         // clang-format on
 
+        // zero-copy: look at the next bytes in place (`peek` does not consume, `skip` does)
+
+        auto peek(uint64_t _size) -> tx_span_t<const uint8_t>;
+        auto skip(uint64_t _size) -> bool;
+
         // invalidate and won't auto-commit
 
         void invalidate();
 
     private:
-        QTYPE&   queue_;
-        uint8_t* storage_;
-        uint64_t head_, cached_tail_, capacity_;
-        bool     invalidated_ : 1;
+        static constexpr auto STAMP_SIZE = uint64_t{QTYPE::has_latency ? 8 : 0};
+
+        QTYPE&                queue_;
+        tx_consumer_t<QTYPE>* consumer_ = nullptr;
+        uint8_t*              storage_;
+        uint64_t              head_, cached_tail_, record_;
+        tx_capacity_t<QTYPE>  capacity_;
+        uint32_t              reader_ = 0;
+        bool                  invalidated_ : 1;
+        bool                  mirrored_ : 1;
+        bool                  claimed_ : 1;
+        bool                  rescued_ : 1;  // claimed from the released records
 
         auto imp_read(void* _buffer, uint64_t _size) -> bool;
+        template<typename... ARGS>
+        auto imp_read_packed(ARGS&... _args) -> bool;
+        auto imp_check_data(uint64_t _size) -> bool;
+        void imp_advance(uint64_t _size);
+        void imp_claim();
+        void imp_finish();
+        void imp_frame();
+        void imp_consume(uint64_t _head);
+        void imp_count(uint64_t tx_counters_t::*_counter, uint64_t _value);
+        void imp_peak(uint64_t _occupancy);
+        void imp_record_latency();
     };
 
 }  // namespace qcstudio
 
 #include "tx-queue.inl"
 
-#pragma warning(pop)
+#if _WIN32
+#    pragma warning(pop)
+#endif
@@ -8,61 +8,122 @@
 
 #pragma push_macro("QCS_INLINE")
 #undef QCS_INLINE
-#define QCS_INLINE __forceinline  // __declspec(noinline) inline || __forceinline
+#if _WIN32
+#    define QCS_INLINE __forceinline  // __declspec(noinline) inline || __forceinline
+#else
+#    define QCS_INLINE inline __attribute__((always_inline))
+#endif
+
+QCS_INLINE constexpr auto qcstudio::tx_numa_t::first_touch() -> tx_numa_t {
+    return {};
+}
+
+QCS_INLINE constexpr auto qcstudio::tx_numa_t::consumer() -> tx_numa_t {
+    return {policy_t::CONSUMER, -1};
+}
+
+QCS_INLINE constexpr auto qcstudio::tx_numa_t::node_of(int32_t _node) -> tx_numa_t {
+    return {policy_t::NODE, _node};
+}
+
+QCS_INLINE constexpr auto qcstudio::tx_numa_t::interleave() -> tx_numa_t {
+    return {policy_t::INTERLEAVE, -1};
+}
 
 QCS_INLINE auto qcstudio::base_tx_queue_t::is_ok() const -> bool {
     return storage_ != nullptr;
 }
 
 QCS_INLINE auto qcstudio::base_tx_queue_t::capacity() const -> uint64_t {
-    return capacity_ - 1;
+    return capacity_;
+}
+
+QCS_INLINE auto qcstudio::base_tx_queue_t::storage() const -> tx_storage_t {
+    return storage_type_;
+}
+
+QCS_INLINE auto qcstudio::base_tx_queue_t::pages() const -> tx_pages_t {
+    return pages_;
 }
 
 QCS_INLINE qcstudio::base_tx_queue_t::operator bool() const noexcept {
     return is_ok();
 }
 
-/*
-    ==
-    SP
-    ==
-*/
+QCS_INLINE auto qcstudio::base_tx_queue_t::numa() const -> tx_numa_t {
+    return {atomic_ref<const tx_numa_t::policy_t>(numa_.policy).load(memory_order_relaxed), atomic_ref<const int32_t>(numa_.node).load(memory_order_relaxed)};
+}
 
-QCS_INLINE qcstudio::tx_queue_sp_t::tx_queue_sp_t(uint64_t _capacity) {
-    // basic checks
+inline auto qcstudio::base_tx_queue_t::place(tx_numa_t _numa) -> bool {
+    // nothing applied so far and nothing asked (the default, no system calls)
 
-    if (_capacity < CACHE_LINE_SIZE) {
-        return;
+    if (_numa.policy == tx_numa_t::policy_t::FIRST_TOUCH && atomic_ref<tx_numa_t::policy_t>(numa_.policy).load(memory_order_relaxed) == tx_numa_t::policy_t::FIRST_TOUCH) {
+        return true;
     }
 
-    // init indices
+    // no storage or a single node: every page is local anyway
 
-    atomic_ref<uint64_t>(status_.head_).store(0);
-    atomic_ref<uint64_t>(status_.tail_).store(0);
+    imp_store_numa(tx_numa_t::first_touch());
+    if (!storage_ || vmem::numa_nodes() < 2) {
+        return false;
+    }
 
-    // force capacity power of 2
+    // the consumer node is not known yet, its first read places the pages
 
-    capacity_ = _capacity;
-    capacity_--;
-    capacity_ |= capacity_ >> 1;
-    capacity_ |= capacity_ >> 2;
-    capacity_ |= capacity_ >> 4;
-    capacity_ |= capacity_ >> 8;
-    capacity_ |= capacity_ >> 16;
-    capacity_ |= capacity_ >> 32;
-    capacity_++;
+    if (_numa.policy == tx_numa_t::policy_t::CONSUMER) {
+        imp_store_numa(_numa);
+        return true;
+    }
 
-    // alloc
+    if (!vmem::place(storage_, capacity_, _numa)) {
+        return false;
+    }
+    imp_store_numa(_numa);
+    return true;
+}
+
+inline void qcstudio::base_tx_queue_t::imp_allocate(uint64_t _capacity, tx_storage_t _storage) {
+    // basic checks (inline storage is only for fixed-capacity queues)
+
+    if (_capacity < CACHE_LINE_SIZE || _storage == tx_storage_t::INLINE) {
+        return;
+    }
+
+    // alloc (the exact capacity, only mirrored storage is rounded up)
+
+    capacity_     = _capacity;
+    storage_type_ = _storage;
+    if (storage_type_ == tx_storage_t::MIRRORED) {
+        const auto granularity = vmem::allocation_granularity();  // power of 2
+        capacity_              = (capacity_ + granularity - 1) & ~(granularity - 1);
+        storage_               = vmem::map_mirrored(capacity_);
+        return;
+    }
+    if (storage_type_ == tx_storage_t::HUGE_PAGES) {
+        const auto huge_page_size = vmem::huge_page_size();  // power of 2
+        storage_                  = vmem::map_huge((capacity_ + huge_page_size - 1) & ~(huge_page_size - 1), pages_);
+        return;
+    }
 
+    const auto allocation_size = (capacity_ + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);  // `aligned_alloc` wants a multiple of the alignment
 #if _WIN32
-    storage_ = (uint8_t*)_aligned_malloc(capacity_, CACHE_LINE_SIZE);
+    storage_ = (uint8_t*)_aligned_malloc(allocation_size, CACHE_LINE_SIZE);
 #else
-    storage_ = (uint8_t*)aligned_alloc(CACHE_LINE_SIZE, capacity_);
+    storage_ = (uint8_t*)aligned_alloc(CACHE_LINE_SIZE, allocation_size);
 #endif
 }
 
-QCS_INLINE qcstudio::tx_queue_sp_t::~tx_queue_sp_t() {
+inline void qcstudio::base_tx_queue_t::imp_release() {
     if (storage_) {
+        if (storage_type_ == tx_storage_t::MIRRORED) {
+            vmem::unmap_mirrored(storage_, capacity_);
+            return;
+        }
+        if (storage_type_ == tx_storage_t::HUGE_PAGES) {
+            const auto huge_page_size = vmem::huge_page_size();
+            vmem::unmap_huge(storage_, (capacity_ + huge_page_size - 1) & ~(huge_page_size - 1));
+            return;
+        }
 #if _WIN32
         _aligned_free(storage_);
 #else
@@ -71,267 +132,2491 @@ QCS_INLINE qcstudio::tx_queue_sp_t::~tx_queue_sp_t() {
     }
 }
 
-/*
-    ==
-    MP
-    ==
-*/
-
-QCS_INLINE qcstudio::tx_queue_mp_t::tx_queue_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity) : status_(*new(_prealloc_and_init) tx_queue_status_t) {
-    // basic checks
-
-    if (!_prealloc_and_init) {
-        return;
-    }
-
+inline void qcstudio::base_tx_queue_t::imp_attach(uint8_t* _storage, uint64_t _capacity, tx_storage_t _storage_type) {
     /*
         notes:
-        ● the passed storage must include room for indices
-        ● the passed capacity must include the size of the indices
-        ● the actual storage must me aligned to the size of the cache line
-        ● the actual capacity must be power of 2
+        ● the storage must me aligned to the size of the cache line
+        ● any capacity but 0
+        ● if mirrored, the storage must be mapped twice back to back (multiple of the allocation granularity)
     */
 
-    auto actual_storage  = _prealloc_and_init + sizeof(tx_queue_status_t);
-    auto actual_capacity = _capacity - sizeof(tx_queue_status_t);
-    if (((uintptr_t)actual_storage & (CACHE_LINE_SIZE - 1)) != 0 ||  // check alignment
-        (actual_capacity & (actual_capacity - 1)) != 0               // check pow of 2
+    if (((uintptr_t)_storage & (CACHE_LINE_SIZE - 1)) != 0 ||  // check alignment
+        _capacity == 0                                         // check size
     ) {
         return;
     }
 
+    if (_storage_type == tx_storage_t::MIRRORED && (((uintptr_t)_storage | _capacity) & (vmem::allocation_granularity() - 1)) != 0) {
+        return;
+    }
+
     // init
 
-    storage_  = actual_storage;
-    capacity_ = actual_capacity;
+    storage_      = _storage;
+    capacity_     = _capacity;
+    storage_type_ = _storage_type;
+    pages_        = _storage_type == tx_storage_t::HUGE_PAGES ? tx_pages_t::EXPLICIT_HUGE : tx_pages_t::REGULAR;  // as the caller says
+}
+
+inline void qcstudio::base_tx_queue_t::imp_place_on_consumer() {
+    // the first consumer to get here places the pages (work and broadcast queues have several), the rest go on
+
+    auto policy = tx_numa_t::policy_t::CONSUMER;
+    if (!atomic_ref<tx_numa_t::policy_t>(numa_.policy).compare_exchange_strong(policy, tx_numa_t::policy_t::NODE, memory_order_relaxed)) {
+        return;
+    }
+    const auto node = vmem::current_node();
+    atomic_ref<int32_t>(numa_.node).store(node, memory_order_relaxed);
+    if (!vmem::place(storage_, capacity_, tx_numa_t::node_of(node))) {
+        imp_store_numa(tx_numa_t::first_touch());
+    }
+}
+
+inline void qcstudio::base_tx_queue_t::imp_store_numa(tx_numa_t _numa) {
+    // transactions load the policy on the consumer thread (`tx_numa_t::consumer()`), hence no plain stores
+
+    atomic_ref<int32_t>(numa_.node).store(_numa.node, memory_order_relaxed);
+    atomic_ref<tx_numa_t::policy_t>(numa_.policy).store(_numa.policy, memory_order_relaxed);
 }
 
 /*
-    =================
-    Write transaction
-    =================
+    =======
+    Cursors
+    =======
 */
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_write_t<QTYPE>::tx_write_t(QTYPE& _queue) : queue_(_queue) {
-    storage_     = queue_.storage_;
-    tail_        = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // relaxed => no sync required as the tail is only modified by the producer (us)
-    cached_head_ = atomic_ref<uint64_t>(queue_.status_.head_).load(memory_order_relaxed);  // optimistic guess, "gimme whatever you have". Later we'll sync if required!
-    capacity_    = queue_.capacity_;                                                       // copy to favour the data locality
-    invalidated_ = !_queue.is_ok();
+QCS_INLINE constexpr auto qcstudio::tx_offset(uint64_t _cursor, uint64_t _capacity) -> uint64_t {
+    return (_capacity & (_capacity - 1)) == 0 ? _cursor & (_capacity - 1) : _cursor % _capacity;
 }
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_write_t<QTYPE>::operator bool() const noexcept {
-    return !invalidated_;
+/*
+    ======
+    Status
+    ======
+*/
+
+template<typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::slowest_head(uint64_t, memory_order _order) -> uint64_t {
+    return atomic_ref<uint64_t>(head_).load(_order);
 }
 
-template<typename QTYPE>
-QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const void* _buffer, uint64_t _size) -> bool {
-    return imp_write(_buffer, _size);
+template<typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::consumer_on_core(int32_t _core) -> bool {
+    return atomic_ref<int32_t>(consumer_core_).load(memory_order_relaxed) == _core;
 }
 
-template<typename QTYPE>
-template<typename T>
-QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const T& _item) -> bool {
-    if constexpr (is_same_v<T, string>) {
-        return imp_write(_item.data(), _item.length());
-    } else {
-        return imp_write(&_item, sizeof(T));
+template<typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::reader_head(uint32_t) -> uint64_t& {
+    return head_;
+}
+
+template<typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::reader_core(uint32_t) -> int32_t& {
+    return consumer_core_;
+}
+
+template<typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::stats() const -> tx_stats_t {
+    auto result = tx_stats_t{};
+    if constexpr (STATS::enabled) {
+        result.producer = stats_.producer_.load();
+        result.consumer = stats_.consumer_.load();
     }
+    return result;
 }
 
-template<typename QTYPE>
-template<typename T, uint64_t N>
-QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const T (&_array)[N]) -> bool {
-    if constexpr (is_same_v<T, char> || is_same_v<T, wchar_t>) {
-        return N > 1 && imp_write(&_array[0], (N - 1) * sizeof(T));  // no "\0" included
+template<typename LAYOUT, typename STATS>
+inline auto qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::latency() const -> tx_latency_t {
+    if constexpr (STATS::latency) {
+        return stats_.latency_.summary();
     } else {
-        return imp_write(&_array[0], N * sizeof(T));
+        return {};
     }
 }
 
-template<typename QTYPE>
-template<typename FIRST, typename... REST>
-QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const FIRST& _first, REST... _rest) -> enable_if_t<!is_pointer_v<FIRST>, bool> {
-    if (!write(_first)) {
-        return false;
+template<typename LAYOUT, typename STATS>
+inline void qcstudio::basic_tx_queue_status_t<LAYOUT, STATS>::describe(uint64_t _capacity) {
+    if constexpr (STATS::enabled) {
+        const auto offset = [this](const void* _field) { return (uint32_t)((const uint8_t*)_field - (const uint8_t*)this); };
+
+        auto& header           = stats_.header_;
+        header.version         = tx_stats_header_t::VERSION;
+        header.line_size       = (uint32_t)LAYOUT::line_size;
+        header.capacity        = _capacity;
+        header.tail_offset     = offset(&tail_);
+        header.head_offset     = offset(&head_);
+        header.producer_offset = offset(&stats_.producer_);
+        header.consumer_offset = offset(&stats_.consumer_);
+        if constexpr (STATS::latency) {
+            header.latency_offset = offset(&stats_.latency_);
+        } else {
+            header.latency_offset = 0;
+        }
+        atomic_ref<uint64_t>(header.magic).store(tx_stats_header_t::MAGIC, memory_order_release);
+        atomic_ref<uint32_t>(stats_offset_).store(offset(&header), memory_order_release);
     }
-    return write(_rest...);
 }
 
-template<typename QTYPE>
-QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::imp_write(const void* _buffer, uint64_t _size) -> bool {
-    if (invalidated_) {
-        return false;
-    }
+/*
+    ========
+    Counters
+    ========
+*/
 
-    auto available_space = (cached_head_ - tail_ - 1 + capacity_) & (capacity_ - 1);
+inline auto qcstudio::tx_counters_t::load() const -> tx_counters_t {
+    const auto counter = [](const uint64_t& _value) { return atomic_ref<const uint64_t>(_value).load(memory_order_relaxed); };
+    return {counter(committed), counter(invalidated), counter(bytes), counter(syncs), counter(wraps), counter(yields), counter(high_water)};
+}
 
-    // sync the head if no space
+/*
+    =======
+    Monitor
+    =======
+*/
 
-    if (_size > available_space) {
-        cached_head_    = atomic_ref<uint64_t>(queue_.status_.head_).load(memory_order_acquire);
-        available_space = (cached_head_ - tail_ - 1 + capacity_) & (capacity_ - 1);
-        if (_size > available_space) {
-            auto current_core = (int)GetCurrentProcessorNumber();
-            atomic_ref<int32_t>(queue_.status_.producer_core_).store(current_core, memory_order_relaxed);
+inline qcstudio::tx_monitor_t::tx_monitor_t(const uint8_t* _memory) {
+    // the offset sits at the same place in every layout, the header is only valid once its magic is there
 
-            // yield if consumer is in the same cpu
+    if (!_memory) {
+        return;
+    }
+    const auto offset = atomic_ref<const uint32_t>(*(const uint32_t*)(_memory + offsetof(tx_queue_status_t, stats_offset_))).load(memory_order_acquire);
+    if (offset == 0) {
+        return;
+    }
+    const auto header = (const tx_stats_header_t*)(_memory + offset);
+    if (atomic_ref<const uint64_t>(header->magic).load(memory_order_acquire) != tx_stats_header_t::MAGIC || header->version != tx_stats_header_t::VERSION) {
+        return;
+    }
+    memory_ = _memory;
+    header_ = header;
+}
 
-            int consumer_core = atomic_ref<int32_t>(queue_.status_.consumer_core_).load(memory_order_relaxed);
-            if (consumer_core != -1 && consumer_core == current_core) {
-                this_thread::yield();
-            }
+inline qcstudio::tx_monitor_t::operator bool() const noexcept {
+    return header_ != nullptr;
+}
 
-            invalidated_ = true;
-            return false;
-        }
-    }
+inline auto qcstudio::tx_monitor_t::capacity() const -> uint64_t {
+    return header_ ? header_->capacity : 0;
+}
 
-    // there is room, hence, write
-    // TODO: optimize memcpy with intrinsics
+inline auto qcstudio::tx_monitor_t::has_latency() const -> bool {
+    return header_ && header_->latency_offset != 0;
+}
 
-    if ((tail_ + _size) > capacity_) {
-        const auto first_chunk_size = capacity_ - tail_;
-        memcpy(storage_ + tail_, _buffer, /*                        */ first_chunk_size);
-        memcpy(storage_, /*   */ (uint8_t*)_buffer + first_chunk_size, _size - first_chunk_size);
-    } else {
-        memcpy(storage_ + tail_, _buffer, _size);
+inline auto qcstudio::tx_monitor_t::sample() const -> tx_sample_t {
+    auto result = tx_sample_t{};
+    if (!header_) {
+        return result;
     }
 
-    // update the tail properly
+    // the head first: the tail read afterwards can only be further, hence the occupancy is never negative
 
-    tail_ = (tail_ + _size) & (capacity_ - 1);
+    const auto cursor = [this](uint32_t _offset) { return atomic_ref<const uint64_t>(*(const uint64_t*)(memory_ + _offset)).load(memory_order_acquire); };
+    result.head       = cursor(header_->head_offset);
+    result.tail       = cursor(header_->tail_offset);
 
-    // reset producer_core_ to -1 only if it was previously set (i.e., not -1)
+    result.stats.producer = ((const tx_counters_t*)(memory_ + header_->producer_offset))->load();
+    result.stats.consumer = ((const tx_counters_t*)(memory_ + header_->consumer_offset))->load();
+    if (header_->latency_offset) {
+        result.latency = ((const tx_histogram_t*)(memory_ + header_->latency_offset))->summary();
+    }
+    return result;
+}
 
-    if (auto prev_core = atomic_ref<int32_t>(queue_.status_.producer_core_).load(memory_order_relaxed); prev_core != -1) {
-        atomic_ref<int32_t>(queue_.status_.producer_core_).store(-1, memory_order_relaxed);
+/*
+    =========
+    Histogram
+    =========
+*/
+
+QCS_INLINE void qcstudio::tx_histogram_t::record(uint64_t _ticks) {
+    // one writer: no RMW required
+
+    auto bucket = atomic_ref<uint64_t>(buckets_[imp_bucket(_ticks)]);
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    if (auto max = atomic_ref<uint64_t>(max_); _ticks > max.load(memory_order_relaxed)) {
+        max.store(_ticks, memory_order_relaxed);
     }
+}
 
-    return true;
+inline auto qcstudio::tx_histogram_t::count() const -> uint64_t {
+    auto result = uint64_t{0};
+    for (const auto& bucket : buckets_) {
+        result += atomic_ref<const uint64_t>(bucket).load(memory_order_relaxed);
+    }
+    return result;
 }
 
-template<typename QTYPE>
-QCS_INLINE void qcstudio::tx_write_t<QTYPE>::invalidate() {
-    invalidated_ = true;
+inline auto qcstudio::tx_histogram_t::max() const -> uint64_t {
+    return atomic_ref<const uint64_t>(max_).load(memory_order_relaxed);
 }
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_write_t<QTYPE>::~tx_write_t() {
-    if (!invalidated_) {
-        atomic_ref<uint64_t>(queue_.status_.tail_).store(tail_, memory_order_release);  // TODO: check how to deal with this in IPC we need to use https://learn.microsoft.com/en-us/windows/win32/sync/interlocked-variable-access
+inline auto qcstudio::tx_histogram_t::percentile(double _percentile) const -> uint64_t {
+    // copy the buckets first, the writer may be moving them
+
+    auto counts = array<uint64_t, BUCKETS>{};
+    auto total  = uint64_t{0};
+    for (auto i = 0u; i < BUCKETS; ++i) {
+        counts[i] = atomic_ref<const uint64_t>(buckets_[i]).load(memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
     }
-}
 
-/*
-    =================
-    read transaction
-    =================
-*/
+    // the first bucket that reaches the rank (never above the exact max)
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_read_t<QTYPE>::tx_read_t(QTYPE& _queue) : queue_(_queue) {
-    storage_     = queue_.storage_;
-    head_        = atomic_ref<uint64_t>(queue_.status_.head_).load(memory_order_relaxed);  // relaxed => no sync required as the head is only modified by the consumer (us)
-    cached_tail_ = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // optimistic guess, "gimme whatever you have". Later we'll sync if required!
-    capacity_    = queue_.capacity_;                                                       // copy to favour the data locality
-    invalidated_ = !_queue.is_ok();
+    const auto rank = std::max<uint64_t>((uint64_t)ceil((double)total * clamp(_percentile, 0.0, 100.0) / 100.0), 1);
+    auto       seen = uint64_t{0};
+    for (auto i = 0u; i < BUCKETS; ++i) {
+        if (seen += counts[i]; seen >= rank) {
+            return min(imp_highest(i), max());
+        }
+    }
+    return max();
 }
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_read_t<QTYPE>::operator bool() const noexcept {
-    return !invalidated_;
+inline auto qcstudio::tx_histogram_t::summary() const -> tx_latency_t {
+    const auto ns = [](uint64_t _ticks) { return (double)_ticks / tsc::ticks_per_ns(); };
+    return {count(), ns(percentile(50.0)), ns(percentile(99.0)), ns(percentile(99.9)), ns(max())};
 }
 
-template<typename QTYPE>
-QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read(void* _buffer, uint64_t _size) -> bool {
-    return imp_read(_buffer, _size);
-}
+QCS_INLINE constexpr auto qcstudio::tx_histogram_t::imp_bucket(uint64_t _ticks) -> uint32_t {
+    // exact below 2 * SUB_BUCKETS, then the top SUB_BITS + 1 bits (the leading one and the linear sub-bucket)
 
-template<typename QTYPE>
-template<typename T>
-QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read(T& _item) -> bool {
-    return imp_read(&_item, sizeof(T));
+    if (_ticks < 2 * SUB_BUCKETS) {
+        return (uint32_t)_ticks;
+    }
+    const auto shift = (uint32_t)bit_width(_ticks) - SUB_BITS - 1;
+    return shift * SUB_BUCKETS + (uint32_t)(_ticks >> shift);
 }
 
-// Helper function to convert a pointer to a reference
+QCS_INLINE constexpr auto qcstudio::tx_histogram_t::imp_highest(uint32_t _bucket) -> uint64_t {
+    if (_bucket < 2 * SUB_BUCKETS) {
+        return _bucket;
+    }
+    const auto shift = _bucket / SUB_BUCKETS - 1;
+    return ((uint64_t{_bucket - shift * SUB_BUCKETS} + 1) << shift) - 1;
+}
 
-template<typename QTYPE>
-template<typename... ARGS>
-QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read() -> enable_if_t<conjunction_v<is_default_constructible<ARGS>...>, tuple<ARGS...>> {
-    if constexpr (sizeof...(ARGS) > 0) {
-        auto temp = tuple<ARGS...>{};
-        if (auto all_read = apply([this](auto&&... _args) { return (this->read(_args) && ...); }, temp)) {
-            return move(temp);
+template<uint32_t READERS>
+QCS_INLINE auto qcstudio::tx_broadcast_status_t<READERS>::slowest_head(uint64_t _tail, memory_order _order) -> uint64_t {
+    // the head with the most pending data (the tail itself if all of them are done)
+
+    auto result  = _tail;
+    auto pending = uint64_t{0};
+    for (auto& reader : readers_) {
+        const auto head = atomic_ref<uint64_t>(reader.head_).load(_order);
+        if (const auto reader_pending = _tail - head; reader_pending > pending) {
+            pending = reader_pending;
+            result  = head;
         }
     }
-    return {};
+    return result;
 }
 
-template<typename QTYPE>
-QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::imp_read(void* _buffer, uint64_t _size) -> bool {
-    if (invalidated_) {
-        return false;
+template<uint32_t READERS>
+QCS_INLINE auto qcstudio::tx_broadcast_status_t<READERS>::consumer_on_core(int32_t _core) -> bool {
+    for (auto& reader : readers_) {
+        if (atomic_ref<int32_t>(reader.consumer_core_).load(memory_order_relaxed) == _core) {
+            return true;
+        }
     }
+    return false;
+}
 
-    auto available_data = (cached_tail_ - head_ + capacity_) & (capacity_ - 1);
+template<uint32_t READERS>
+QCS_INLINE auto qcstudio::tx_broadcast_status_t<READERS>::reader_head(uint32_t _reader) -> uint64_t& {
+    return readers_[_reader].head_;
+}
 
-    // sync the head if no space
+template<uint32_t READERS>
+QCS_INLINE auto qcstudio::tx_broadcast_status_t<READERS>::reader_core(uint32_t _reader) -> int32_t& {
+    return readers_[_reader].consumer_core_;
+}
 
-    if (_size > available_data) {
-        cached_tail_   = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_acquire);
-        available_data = (cached_tail_ - head_ + capacity_) & (capacity_ - 1);
-        if (_size > available_data) {
-            auto current_core = (int)GetCurrentProcessorNumber();
-            atomic_ref<int32_t>(queue_.status_.consumer_core_).store(current_core, memory_order_relaxed);
+QCS_INLINE auto qcstudio::tx_work_status_t::slowest_head(uint64_t, memory_order _order) -> uint64_t {
+    return atomic_ref<uint64_t>(head_).load(_order);
+}
 
-            // yield if producer is in the same cpu
+QCS_INLINE auto qcstudio::tx_work_status_t::consumer_on_core(int32_t _core) -> bool {
+    return atomic_ref<int32_t>(consumer_core_).load(memory_order_relaxed) == _core;
+}
 
-            int producer_core = atomic_ref<int32_t>(queue_.status_.producer_core_).load(memory_order_relaxed);
-            if (producer_core != -1 && producer_core == current_core) {
-                this_thread::yield();
-            }
+QCS_INLINE auto qcstudio::tx_work_status_t::reader_head(uint32_t) -> uint64_t& {
+    return claim_;
+}
 
-            invalidated_ = true;
-            return false;
-        }
-    }
+QCS_INLINE auto qcstudio::tx_work_status_t::reader_core(uint32_t) -> int32_t& {
+    return consumer_core_;
+}
 
-    // there is data, hence, read
-    // TODO: optimize memcpy with intrinsics
+/*
+    ==============
+    Virtual memory
+    ==============
+*/
 
-    if ((head_ + _size) > capacity_) {
-        const auto first_chunk_size = capacity_ - head_;
-        memcpy(_buffer, /*                        */ storage_ + head_, first_chunk_size);
-        memcpy((uint8_t*)_buffer + first_chunk_size, storage_, /*   */ _size - first_chunk_size);
-    } else {
-        memcpy(_buffer, storage_ + head_, _size);
+inline auto qcstudio::vmem::allocation_granularity() -> uint64_t {
+#if _WIN32
+    auto info = SYSTEM_INFO{};
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;  // views must be placed on 64 KiB boundaries
+#else
+    return (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+inline auto qcstudio::vmem::map_mirrored(uint64_t _size) -> uint8_t* {
+    if (_size == 0 || (_size & (allocation_granularity() - 1)) != 0) {
+        return nullptr;
     }
 
-    // update the tail properly
+#if _WIN32
+    // reserve a placeholder for both views and split it in two halves
 
-    head_ = (head_ + _size) & (capacity_ - 1);
+    auto section = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(_size >> 32), (DWORD)(_size & 0xFFffFFff), nullptr);
+    if (!section) {
+        return nullptr;
+    }
 
-    // reset producer_core_ to -1 only if it was previously set (i.e., not -1)
+    auto result = (uint8_t*)VirtualAlloc2(nullptr, nullptr, 2 * _size, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, nullptr, 0);
+    if (!result) {
+        CloseHandle(section);
+        return nullptr;
+    }
+    VirtualFree(result, _size, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER);
+
+    // map the section on each half (the views keep the section alive)
+
+    auto view0 = MapViewOfFile3(section, nullptr, result, 0, _size, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+    auto view1 = MapViewOfFile3(section, nullptr, result + _size, 0, _size, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+    CloseHandle(section);
+    if (!view0 || !view1) {
+        for (auto [view, half] : {pair{view0, result}, pair{view1, result + _size}}) {
+            if (view) {
+                UnmapViewOfFile(view);
+            } else {
+                VirtualFree(half, 0, MEM_RELEASE);  // still a placeholder
+            }
+        }
+        return nullptr;
+    }
+    return result;
+#else
+    // reserve the address range for both views and map the memfd twice on top of it
 
-    if (auto prev_core = atomic_ref<int32_t>(queue_.status_.consumer_core_).load(memory_order_relaxed); prev_core != -1) {
-        atomic_ref<int32_t>(queue_.status_.consumer_core_).store(-1, memory_order_relaxed);
+    auto fd = memfd_create("tx-queue", MFD_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
     }
 
-    return true;
+    auto result = (uint8_t*)MAP_FAILED;
+    if (ftruncate(fd, (off_t)_size) == 0) {
+        result = (uint8_t*)mmap(nullptr, 2 * _size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (result != MAP_FAILED) {
+            if (mmap(result, _size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                mmap(result + _size, _size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                munmap(result, 2 * _size);
+                result = (uint8_t*)MAP_FAILED;
+            }
+        }
+    }
+    close(fd);  // the mappings keep the memory alive
+    return result != MAP_FAILED ? result : nullptr;
+#endif
 }
 
-template<typename QTYPE>
-QCS_INLINE void qcstudio::tx_read_t<QTYPE>::invalidate() {
-    invalidated_ = true;
+inline void qcstudio::vmem::unmap_mirrored(uint8_t* _address, uint64_t _size) {
+    if (!_address) {
+        return;
+    }
+#if _WIN32
+    UnmapViewOfFile(_address);
+    UnmapViewOfFile(_address + _size);
+#else
+    munmap(_address, 2 * _size);
+#endif
 }
 
-template<typename QTYPE>
-QCS_INLINE qcstudio::tx_read_t<QTYPE>::~tx_read_t() {
-    if (!invalidated_) {
-        atomic_ref<uint64_t>(queue_.status_.head_).store(head_, memory_order_release);  // TODO: check how to deal with this in IPC we need to use https://learn.microsoft.com/en-us/windows/win32/sync/interlocked-variable-access
+inline auto qcstudio::vmem::huge_page_size() -> uint64_t {
+#if _WIN32
+    static const auto result = max<uint64_t>(GetLargePageMinimum(), 2 * 1024 * 1024);  // 0 if not supported
+    return result;
+#else
+    return 2 * 1024 * 1024;  // the default size of `MAP_HUGETLB` on x64
+#endif
+}
+
+inline auto qcstudio::vmem::enable_huge_pages() -> bool {
+    // large pages need the "lock pages in memory" privilege, enabled once per process
+
+#if _WIN32
+    static const auto result = []() {
+        auto token = HANDLE{};
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            return false;
+        }
+        auto privileges                     = TOKEN_PRIVILEGES{};
+        privileges.PrivilegeCount           = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        const auto enabled                  = LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+                             AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && GetLastError() == ERROR_SUCCESS;  // not held: ERROR_NOT_ALL_ASSIGNED
+        CloseHandle(token);
+        return enabled;
+    }();
+    return result;
+#else
+    return true;
+#endif
+}
+
+inline auto qcstudio::vmem::map_huge(uint64_t _size, tx_pages_t& _pages) -> uint8_t* {
+    _pages = tx_pages_t::REGULAR;
+    if (_size == 0 || (_size & (huge_page_size() - 1)) != 0) {
+        return nullptr;
+    }
+
+#if _WIN32
+    if (enable_huge_pages()) {
+        if (auto result = (uint8_t*)VirtualAlloc(nullptr, _size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE)) {
+            _pages = tx_pages_t::EXPLICIT_HUGE;
+            return result;
+        }
+    }
+    return (uint8_t*)VirtualAlloc(nullptr, _size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);  // no transparent huge pages on windows
+#else
+    // explicit huge pages (reserved upon mapping, so it fails here rather than on first touch if the pool is short)
+
+#    ifdef MAP_HUGETLB
+    if (auto result = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0); result != MAP_FAILED) {
+        _pages = tx_pages_t::EXPLICIT_HUGE;
+        return (uint8_t*)result;
+    }
+#    endif
+
+    // transparent huge pages: a range aligned to the huge page size (trimmed from a bigger one) so all of it can be merged
+
+    const auto huge_page = huge_page_size();
+    auto       raw       = (uint8_t*)mmap(nullptr, _size + huge_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto result = (uint8_t*)(((uintptr_t)raw + huge_page - 1) & ~(uintptr_t)(huge_page - 1));
+    if (result != raw) {
+        munmap(raw, result - raw);
+    }
+    munmap(result + _size, (raw + huge_page) - result);
+    if (madvise(result, _size, MADV_HUGEPAGE) == 0) {
+        _pages = tx_pages_t::TRANSPARENT_HUGE;
+    }
+    return result;
+#endif
+}
+
+inline void qcstudio::vmem::unmap_huge(uint8_t* _address, uint64_t _size) {
+    if (!_address) {
+        return;
+    }
+#if _WIN32
+    VirtualFree(_address, 0, MEM_RELEASE);
+#else
+    munmap(_address, _size);
+#endif
+}
+
+inline auto qcstudio::vmem::numa_nodes() -> uint32_t {
+#if _WIN32
+    return 1;  // no placement of existing pages
+#else
+    static const auto result = []() {
+        unsigned long allowed[NUMA_MAX_NODES / 64] = {};
+        if (syscall(SYS_get_mempolicy, nullptr, allowed, NUMA_MAX_NODES, nullptr, MPOL_F_MEMS_ALLOWED) != 0) {
+            return 1u;
+        }
+        auto count = 0u;
+        for (auto word : allowed) {
+            count += (uint32_t)popcount(word);
+        }
+        return max(count, 1u);
+    }();
+    return result;
+#endif
+}
+
+inline auto qcstudio::vmem::current_node() -> int32_t {
+#if _WIN32
+    auto processor = PROCESSOR_NUMBER{};
+    auto node      = USHORT{0};
+    GetCurrentProcessorNumberEx(&processor);
+    return GetNumaProcessorNodeEx(&processor, &node) ? (int32_t)node : 0;
+#else
+    auto cpu = 0u, node = 0u;
+    return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? (int32_t)node : 0;
+#endif
+}
+
+inline auto qcstudio::vmem::place(uint8_t* _address, uint64_t _size, tx_numa_t _numa) -> bool {
+#if _WIN32
+    return _numa.policy == tx_numa_t::policy_t::FIRST_TOUCH;
+#else
+    // the pages entirely within the range (the others may hold someone else's data)
+
+    const auto page  = (uintptr_t)sysconf(_SC_PAGESIZE);
+    const auto start = ((uintptr_t)_address + page - 1) & ~(page - 1);
+    const auto end   = ((uintptr_t)_address + _size) & ~(page - 1);
+    if (start >= end) {
+        return false;
+    }
+
+    // first touch is the default policy (the pages stay where they are), the others move the pages already touched
+
+    unsigned long nodes[NUMA_MAX_NODES / 64] = {};
+    switch (_numa.policy) {
+        case tx_numa_t::policy_t::NODE:
+            if (_numa.node < 0 || _numa.node >= NUMA_MAX_NODES) {
+                return false;
+            }
+            nodes[_numa.node / 64] = 1ul << (_numa.node % 64);
+            return syscall(SYS_mbind, start, end - start, MPOL_BIND, nodes, NUMA_MAX_NODES + 1, MPOL_MF_MOVE) == 0;  // `maxnode` counts one past the last bit
+        case tx_numa_t::policy_t::INTERLEAVE:
+            if (syscall(SYS_get_mempolicy, nullptr, nodes, NUMA_MAX_NODES, nullptr, MPOL_F_MEMS_ALLOWED) != 0) {
+                return false;
+            }
+            return syscall(SYS_mbind, start, end - start, MPOL_INTERLEAVE, nodes, NUMA_MAX_NODES + 1, MPOL_MF_MOVE) == 0;
+        case tx_numa_t::policy_t::FIRST_TOUCH:
+            return syscall(SYS_mbind, start, end - start, MPOL_DEFAULT, nullptr, 0, 0) == 0;
+        default:
+            return false;  // `consumer()` is resolved into a node first
+    }
+#endif
+}
+
+/*
+    =====
+    Futex
+    =====
+*/
+
+inline void qcstudio::futex::wait(uint32_t* _address, uint32_t _expected, bool _shared, tx_deadline_t _deadline) {
+    using namespace chrono;
+
+    const auto infinite = _deadline == tx_deadline_t::max();
+    const auto timeout  = infinite ? nanoseconds{} : duration_cast<nanoseconds>(_deadline - steady_clock::now());
+    if (!infinite && timeout.count() <= 0) {
+        return;
+    }
+
+#if _WIN32
+    if (_shared) {
+        this_thread::sleep_for(min<nanoseconds>(infinite ? 1ms : timeout, 1ms));  // no cross-process wake up available
+    } else {
+        WaitOnAddress(_address, &_expected, sizeof(uint32_t), infinite ? INFINITE : (DWORD)ceil<milliseconds>(timeout).count());
+    }
+#else
+    auto ts = timespec{(time_t)(timeout.count() / 1'000'000'000), (long)(timeout.count() % 1'000'000'000)};
+    syscall(SYS_futex, _address, _shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, _expected, infinite ? nullptr : &ts, nullptr, 0);
+#endif
+}
+
+inline void qcstudio::futex::wake_all(uint32_t* _address, bool _shared) {
+#if _WIN32
+    if (!_shared) {
+        WakeByAddressAll(_address);
+    }
+#else
+    syscall(SYS_futex, _address, _shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/*
+    ===
+    TSC
+    ===
+*/
+
+QCS_INLINE auto qcstudio::tsc::now() -> uint64_t {
+    return __rdtsc();
+}
+
+inline auto qcstudio::tsc::ticks_per_ns() -> double {
+    static const auto ticks_per_ns = []() {
+        using namespace chrono;
+
+        const auto start_time  = steady_clock::now();
+        const auto start_ticks = now();
+        this_thread::sleep_for(10ms);
+        const auto end_ticks = now();
+        const auto end_time  = steady_clock::now();
+        return (double)(end_ticks - start_ticks) / (double)duration_cast<nanoseconds>(end_time - start_time).count();
+    }();
+    return ticks_per_ns;
+}
+
+/*
+    ===
+    CPU
+    ===
+*/
+
+QCS_INLINE auto qcstudio::cpu::current() -> int32_t {
+#if _WIN32
+    return (int32_t)GetCurrentProcessorNumber();
+#else
+#    if QCS_HAS_RSEQ
+    // the kernel rewrites `cpu_id` on every migration (negative until registered)
+
+    if (__rseq_size) {
+        const auto area = (const volatile struct rseq*)((const uint8_t*)__builtin_thread_pointer() + __rseq_offset);
+        if (const auto core = (int32_t)area->cpu_id; core >= 0) {
+            return core;
+        }
+    }
+#    endif
+    const auto core = sched_getcpu();
+    return core >= 0 ? core : -2;
+#endif
+}
+
+/*
+    ===============
+    Wait strategies
+    ===============
+*/
+
+template<typename READY>
+QCS_INLINE auto qcstudio::tx_wait_spin_t::wait(tx_wait_word_t&, bool, tx_deadline_t _deadline, READY&& _ready) -> bool {
+    while (!_ready()) {
+        if (chrono::steady_clock::now() >= _deadline) {
+            return false;
+        }
+        _mm_pause();
+    }
+    return true;
+}
+
+QCS_INLINE void qcstudio::tx_wait_spin_t::notify(tx_wait_word_t&, bool) {
+}
+
+template<typename READY>
+QCS_INLINE auto qcstudio::tx_wait_yield_t::wait(tx_wait_word_t&, bool, tx_deadline_t _deadline, READY&& _ready) -> bool {
+    for (auto iteration = 0u; !_ready(); ++iteration) {
+        if (chrono::steady_clock::now() >= _deadline) {
+            return false;
+        }
+        if (iteration < SPINS) {
+            _mm_pause();
+        } else {
+            this_thread::yield();
+        }
+    }
+    return true;
+}
+
+QCS_INLINE void qcstudio::tx_wait_yield_t::notify(tx_wait_word_t&, bool) {
+}
+
+template<typename READY>
+QCS_INLINE auto qcstudio::tx_wait_futex_t::wait(tx_wait_word_t& _word, bool _shared, tx_deadline_t _deadline, READY&& _ready) -> bool {
+    for (auto iteration = 0u; !_ready(); ++iteration) {
+        if (chrono::steady_clock::now() >= _deadline) {
+            return false;
+        }
+        if (iteration < SPINS) {
+            _mm_pause();
+            continue;
+        }
+
+        // register as sleeper, re-check and sleep only if nobody committed in between
+
+        auto epoch = atomic_ref<uint32_t>(_word.epoch_).load(memory_order_acquire);
+        atomic_ref<uint32_t>(_word.sleepers_).fetch_add(1, memory_order_seq_cst);
+        if (!_ready()) {
+            futex::wait(&_word.epoch_, epoch, _shared, _deadline);
+        }
+        atomic_ref<uint32_t>(_word.sleepers_).fetch_sub(1, memory_order_relaxed);
+    }
+    return true;
+}
+
+QCS_INLINE void qcstudio::tx_wait_futex_t::notify(tx_wait_word_t& _word, bool _shared) {
+    // pairs with the sleeper registration: either we see it or it sees our commit
+
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_ref<uint32_t>(_word.sleepers_).load(memory_order_relaxed) != 0) {
+        atomic_ref<uint32_t>(_word.epoch_).fetch_add(1, memory_order_release);
+        futex::wake_all(&_word.epoch_, _shared);
+    }
+}
+
+/*
+    ========
+    Blocking
+    ========
+*/
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::write_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline) -> bool {
+    if constexpr (QTYPE::is_work_queue || QTYPE::is_multi_producer) {
+        if (_size > QTYPE::MAX_RECORD_SIZE) {
+            return false;
+        }
+        _size += QTYPE::HEADER_SIZE * 2 - 1;  // the record header and its padding
+    }
+    if constexpr (QTYPE::has_latency) {
+        _size += QTYPE::STAMP_SIZE;  // the transaction reserves it in front of the payload
+    }
+    if (!_queue.is_ok() || _size > _queue.capacity_) {
+        return false;
+    }
+
+    return QTYPE::wait_t::wait(_queue.status_.space_ready_, QTYPE::is_shared, _deadline, [&] {
+        if constexpr (QTYPE::is_work_queue) {
+            _queue.imp_reclaim();
+        }
+
+        auto tail = uint64_t{};
+        if constexpr (QTYPE::is_multi_producer) {
+            tail = atomic_ref<uint64_t>(_queue.reserve_).load(memory_order_relaxed);  // other producers move it
+        } else {
+            tail = atomic_ref<uint64_t>(_queue.status_.tail_).load(memory_order_relaxed);  // we are the producer
+        }
+        const auto head = _queue.status_.slowest_head(tail, memory_order_acquire);
+        return _queue.capacity_ - (tail - head) >= _size;
+    });
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::read_wait(QTYPE& _queue, uint64_t _size, tx_deadline_t _deadline) -> bool {
+    static_assert(!QTYPE::is_broadcast, "broadcast queues need the reader: read_wait(queue, reader, size)");
+    return read_wait(_queue, 0, _size, _deadline);
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::read_wait(QTYPE& _queue, uint32_t _reader, uint64_t _size, tx_deadline_t _deadline) -> bool {
+    if constexpr (QTYPE::has_latency) {
+        _size += QTYPE::STAMP_SIZE;  // the transaction reads it in front of the payload
+    }
+    if constexpr (QTYPE::is_multi_producer) {
+        _size += QTYPE::HEADER_SIZE;  // the record header
+    }
+    if constexpr (QTYPE::is_broadcast) {
+        if (_reader >= QTYPE::readers) {
+            return false;
+        }
+    }
+    if (!_queue.is_ok() || _size > _queue.capacity_) {
+        return false;
+    }
+
+    // work queues: any record will do (the size is not known until it is claimed), other consumers move the claim
+
+    if constexpr (QTYPE::is_work_queue) {
+        return QTYPE::wait_t::wait(_queue.status_.data_ready_, QTYPE::is_shared, _deadline, [&] {
+            const auto claim = atomic_ref<uint64_t>(_queue.status_.claim_).load(memory_order_relaxed);
+            const auto tail  = atomic_ref<uint64_t>(_queue.status_.tail_).load(memory_order_acquire);
+            return tail != claim || atomic_ref<uint64_t>(_queue.status_.released_).load(memory_order_relaxed) != 0;
+        });
+    }
+
+    const auto head = atomic_ref<uint64_t>(_queue.status_.reader_head(_reader)).load(memory_order_relaxed);  // we are the consumer
+    return QTYPE::wait_t::wait(_queue.status_.data_ready_, QTYPE::is_shared, _deadline, [&] {
+        const auto tail = atomic_ref<uint64_t>(_queue.status_.tail_).load(memory_order_acquire);
+        return tail - head >= _size;
+    });
+}
+
+/*
+    ====
+    Span
+    ====
+*/
+
+template<typename T>
+QCS_INLINE auto qcstudio::tx_span_t<T>::size() const -> uint64_t {
+    return first.size() + second.size();
+}
+
+template<typename T>
+QCS_INLINE auto qcstudio::tx_span_t<T>::empty() const -> bool {
+    return first.empty();
+}
+
+/*
+    ==
+    SP
+    ==
+*/
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE qcstudio::tx_queue_sp_t<WAIT, LAYOUT, STATS>::tx_queue_sp_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa) {
+    // init indices
+
+    atomic_ref<uint64_t>(status_.head_).store(0);
+    atomic_ref<uint64_t>(status_.tail_).store(0);
+    status_.cached_head_   = 0;
+    status_.cached_tail_   = 0;
+    status_.producer_core_ = -1;
+    status_.consumer_core_ = -1;
+    status_.stats_offset_  = 0;
+    status_.data_ready_    = {};
+    status_.space_ready_   = {};
+    status_.stats_         = {};
+
+    // alloc
+
+    imp_allocate(_capacity, _storage);
+    place(_numa);
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE qcstudio::tx_queue_sp_t<WAIT, LAYOUT, STATS>::~tx_queue_sp_t() {
+    imp_release();
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_sp_t<WAIT, LAYOUT, STATS>::stats() const -> tx_stats_t {
+    return status_.stats();
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_sp_t<WAIT, LAYOUT, STATS>::latency() const -> tx_latency_t {
+    return status_.latency();
+}
+
+/*
+    ====
+    MPSC
+    ====
+*/
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE qcstudio::tx_queue_mpsc_t<WAIT, LAYOUT, STATS>::tx_queue_mpsc_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa)
+    : tx_queue_sp_t<WAIT, LAYOUT, STATS>((_capacity + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1), _storage, _numa) {  // headers never wrap around
+    atomic_ref<uint64_t>(reserve_).store(0);
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_mpsc_t<WAIT, LAYOUT, STATS>::imp_header(uint64_t _position) -> uint64_t& {
+    return *(uint64_t*)(this->storage_ + tx_offset(_position, this->capacity_));
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_mpsc_t<WAIT, LAYOUT, STATS>::imp_pack(uint64_t _size, state_t _state) -> uint64_t {
+    return _size | ((uint64_t)_state << 32);
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_mpsc_t<WAIT, LAYOUT, STATS>::imp_padded(uint64_t _size) -> uint64_t {
+    return (_size + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1);
+}
+
+/*
+    ==
+    MP
+    ==
+*/
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE qcstudio::tx_queue_mp_t<WAIT, LAYOUT, STATS>::tx_queue_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa)
+    : status_(*new(_prealloc_and_init) status_t) {
+    // nothing is initialized here: the other process may be using the status already (a fresh segment is zeroed),
+    // the core hints aside (a late attach costs the other side a yield at most)
+
+    if (_prealloc_and_init) {
+        atomic_ref<int32_t>(status_.producer_core_).store(-1, memory_order_relaxed);
+        atomic_ref<int32_t>(status_.consumer_core_).store(-1, memory_order_relaxed);
+    }
+
+    // the passed storage and capacity include room for the indices (aligned as the layout says)
+
+    if (_prealloc_and_init && ((uintptr_t)_prealloc_and_init & (LAYOUT::line_size - 1)) == 0 && _capacity > sizeof(status_t)) {
+        imp_attach(_prealloc_and_init + sizeof(status_t), _capacity - sizeof(status_t), _storage);
+    }
+    if (is_ok()) {
+        status_.describe(capacity_);  // for monitors (`tx_monitor_t`), the same values from both processes
+    }
+    place(_numa);
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_mp_t<WAIT, LAYOUT, STATS>::stats() const -> tx_stats_t {
+    return status_.stats();
+}
+
+template<typename WAIT, typename LAYOUT, typename STATS>
+QCS_INLINE auto qcstudio::tx_queue_mp_t<WAIT, LAYOUT, STATS>::latency() const -> tx_latency_t {
+    return status_.latency();
+}
+
+/*
+    ==============
+    Fixed capacity
+    ==============
+*/
+
+template<uint64_t CAPACITY, qcstudio::tx_storage_t STORAGE, typename WAIT>
+QCS_INLINE qcstudio::tx_queue_sp_fixed_t<CAPACITY, STORAGE, WAIT>::tx_queue_sp_fixed_t(tx_numa_t _numa) {
+    // init indices
+
+    atomic_ref<uint64_t>(status_.tail_).store(0);
+    atomic_ref<uint64_t>(status_.head_).store(0);
+    status_.cached_head_   = 0;
+    status_.cached_tail_   = 0;
+    status_.producer_core_ = -1;
+    status_.consumer_core_ = -1;
+    status_.stats_offset_  = 0;
+    status_.data_ready_    = {};
+    status_.space_ready_   = {};
+
+    // storage: ours or allocated (a mirrored one may be rounded up, then it is not ours to use)
+
+    if constexpr (STORAGE == tx_storage_t::INLINE) {
+        storage_      = inline_;
+        capacity_     = CAPACITY;
+        storage_type_ = STORAGE;
+    } else {
+        imp_allocate(CAPACITY, STORAGE);
+        if (capacity_ != CAPACITY) {
+            imp_release();
+            storage_ = nullptr;
+        }
+    }
+    place(_numa);
+}
+
+template<uint64_t CAPACITY, qcstudio::tx_storage_t STORAGE, typename WAIT>
+QCS_INLINE qcstudio::tx_queue_sp_fixed_t<CAPACITY, STORAGE, WAIT>::~tx_queue_sp_fixed_t() {
+    if constexpr (STORAGE != tx_storage_t::INLINE) {
+        imp_release();
+    }
+}
+
+template<uint64_t CAPACITY, typename WAIT>
+QCS_INLINE qcstudio::tx_queue_mp_fixed_t<CAPACITY, WAIT>::tx_queue_mp_fixed_t(uint8_t* _prealloc_and_init, tx_storage_t _storage, tx_numa_t _numa)
+    : status_(*new(_prealloc_and_init) tx_queue_status_t) {
+    // nothing is initialized but the core hints, see `tx_queue_mp_t`; the storage follows the indices
+
+    if (_prealloc_and_init) {
+        atomic_ref<int32_t>(status_.producer_core_).store(-1, memory_order_relaxed);
+        atomic_ref<int32_t>(status_.consumer_core_).store(-1, memory_order_relaxed);
+        imp_attach(_prealloc_and_init + sizeof(tx_queue_status_t), CAPACITY, _storage);
+    }
+    place(_numa);
+}
+
+/*
+    =========
+    Broadcast
+    =========
+*/
+
+template<uint32_t READERS, typename WAIT>
+QCS_INLINE qcstudio::tx_broadcast_sp_t<READERS, WAIT>::tx_broadcast_sp_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa) {
+    static_assert(READERS > 0);
+
+    // init indices
+
+    atomic_ref<uint64_t>(status_.tail_).store(0);
+    status_.producer_core_ = -1;
+    status_.data_ready_    = {};
+    status_.space_ready_   = {};
+    for (auto& reader : status_.readers_) {
+        atomic_ref<uint64_t>(reader.head_).store(0);
+        reader.consumer_core_ = -1;
+    }
+
+    // alloc
+
+    imp_allocate(_capacity, _storage);
+    place(_numa);
+}
+
+template<uint32_t READERS, typename WAIT>
+QCS_INLINE qcstudio::tx_broadcast_sp_t<READERS, WAIT>::~tx_broadcast_sp_t() {
+    imp_release();
+}
+
+template<uint32_t READERS, typename WAIT>
+QCS_INLINE qcstudio::tx_broadcast_mp_t<READERS, WAIT>::tx_broadcast_mp_t(uint8_t* _prealloc_and_init, uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa)
+    : status_(*new(_prealloc_and_init) tx_broadcast_status_t<READERS>) {
+    static_assert(READERS > 0);
+
+    // nothing is initialized but the core hints, see `tx_queue_mp_t`
+
+    if (_prealloc_and_init) {
+        atomic_ref<int32_t>(status_.producer_core_).store(-1, memory_order_relaxed);
+        for (auto& reader : status_.readers_) {
+            atomic_ref<int32_t>(reader.consumer_core_).store(-1, memory_order_relaxed);
+        }
+    }
+
+    // the passed storage and capacity include room for the indices
+
+    if (_prealloc_and_init && _capacity > sizeof(tx_broadcast_status_t<READERS>)) {
+        imp_attach(_prealloc_and_init + sizeof(tx_broadcast_status_t<READERS>), _capacity - sizeof(tx_broadcast_status_t<READERS>), _storage);
+    }
+    place(_numa);
+}
+
+/*
+    ==========
+    Work queue
+    ==========
+*/
+
+template<typename WAIT>
+QCS_INLINE qcstudio::tx_queue_spmc_t<WAIT>::tx_queue_spmc_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa) {
+    // init indices
+
+    atomic_ref<uint64_t>(status_.tail_).store(0);
+    atomic_ref<uint64_t>(status_.claim_).store(0);
+    atomic_ref<uint64_t>(status_.released_).store(0);
+    atomic_ref<uint64_t>(status_.head_).store(0);
+    status_.producer_core_ = -1;
+    status_.consumer_core_ = -1;
+    status_.data_ready_    = {};
+    status_.space_ready_   = {};
+
+    // alloc (the headers are 8-byte aligned and never wrap around as long as the capacity is a multiple of 8)
+
+    imp_allocate((_capacity + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1), _storage);
+    place(_numa);
+}
+
+template<typename WAIT>
+QCS_INLINE qcstudio::tx_queue_spmc_t<WAIT>::~tx_queue_spmc_t() {
+    imp_release();
+}
+
+template<typename WAIT>
+QCS_INLINE auto qcstudio::tx_queue_spmc_t<WAIT>::imp_header(uint64_t _position) -> uint64_t& {
+    return *(uint64_t*)(storage_ + tx_offset(_position, capacity_));
+}
+
+template<typename WAIT>
+QCS_INLINE void qcstudio::tx_queue_spmc_t<WAIT>::imp_reclaim() {
+    // producer only: move the head over the finished records, it stops at the first one still claimed (or unclaimed)
+
+    const auto start = atomic_ref<uint64_t>(status_.head_).load(memory_order_relaxed);
+    const auto claim = atomic_ref<uint64_t>(status_.claim_).load(memory_order_acquire);
+
+    auto head = start;
+    while (head != claim) {
+        const auto header = atomic_ref<uint64_t>(imp_header(head)).load(memory_order_acquire);
+        if ((state_t)(header >> 32) != state_t::DONE) {
+            break;
+        }
+        head += HEADER_SIZE + imp_padded(header & 0xFFFF'FFFF);
+    }
+
+    // the fence orders the head before the writes that reuse the space (consumers scanning the released records validate the head after reading a header)
+
+    if (head != start) {
+        atomic_ref<uint64_t>(status_.head_).store(head, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+}
+
+template<typename WAIT>
+QCS_INLINE auto qcstudio::tx_queue_spmc_t<WAIT>::imp_pack(uint64_t _size, state_t _state) -> uint64_t {
+    return _size | ((uint64_t)_state << 32);
+}
+
+template<typename WAIT>
+QCS_INLINE auto qcstudio::tx_queue_spmc_t<WAIT>::imp_padded(uint64_t _size) -> uint64_t {
+    return (_size + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1);
+}
+
+/*
+    =====
+    Lanes
+    =====
+*/
+
+template<typename WAIT>
+QCS_INLINE qcstudio::tx_lane_t<WAIT>::tx_lane_t(uint64_t _capacity, tx_storage_t _storage, tx_numa_t _numa, uint64_t* _ready, uint64_t _bit, tx_wait_word_t* _ready_word)
+    : tx_queue_sp_t<WAIT>(_capacity, _storage, _numa), ready_(_ready), bit_(_bit), ready_word_(_ready_word) {
+}
+
+template<typename WAIT>
+QCS_INLINE void qcstudio::tx_lane_t<WAIT>::imp_signal() {
+    // check the flag after the tail is published, as the consumer clears it before checking the tail again
+    // (without the fence both sides could miss each other)
+
+    atomic_thread_fence(memory_order_seq_cst);
+    auto ready = atomic_ref<uint64_t>(*ready_);
+    if ((ready.load(memory_order_relaxed) & bit_) == 0) {
+        ready.fetch_or(bit_, memory_order_release);
+        WAIT::notify(*ready_word_, false);
+    }
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE qcstudio::tx_lane_set_t<LANES, WAIT>::tx_lane_set_t(uint64_t _lane_capacity, tx_storage_t _storage, tx_numa_t _numa)
+    : taken_(make_shared<taken_t>()), lane_capacity_(_lane_capacity), storage_(_storage), numa_(_numa), none_(0, tx_storage_t::HEAP, {}, ready_, 0, &ready_word_) {
+    static_assert(LANES > 0);
+    static auto next_id = atomic<uint64_t>{1};
+    id_                 = next_id.fetch_add(1, memory_order_relaxed);
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE qcstudio::tx_lane_set_t<LANES, WAIT>::operator bool() const noexcept {
+    return lane_capacity_ >= CACHE_LINE_SIZE;
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE auto qcstudio::tx_lane_set_t<LANES, WAIT>::lane() -> lane_t& {
+    // registered already (usually the only set used by the thread)
+
+    auto& registrations = imp_registrations();
+    for (auto& registration : registrations) {
+        if (registration.set == id_) {
+            return *lanes_[registration.lane];
+        }
+    }
+
+    // take a free lane, created on first use (the consumer only sees it once it is flagged)
+
+    for (auto w = 0u; w < WORDS; ++w) {
+        auto taken   = atomic_ref<uint64_t>(taken_->words[w]);
+        auto current = taken.load(memory_order_relaxed);
+        while (const auto free = ~current & imp_valid_bits(w)) {
+            const auto bit = (uint32_t)countr_zero(free);
+            if (taken.compare_exchange_weak(current, current | (1ull << bit), memory_order_acquire)) {
+                const auto index = w * 64 + bit;
+                if (!lanes_[index]) {
+                    lanes_[index] = make_unique<lane_t>(lane_capacity_, storage_, numa_, &ready_[w], 1ull << bit, &ready_word_);
+                }
+                registrations.push_back({id_, index, taken_});
+                return *lanes_[index];
+            }
+        }
+    }
+
+    // all taken: invalid lane
+
+    return none_;
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE void qcstudio::tx_lane_set_t<LANES, WAIT>::leave() {
+    auto& registrations = imp_registrations();
+    for (auto it = registrations.begin(); it != registrations.end(); ++it) {
+        if (it->set == id_) {
+            imp_release(*it);
+            registrations.erase(it);
+            return;
+        }
+    }
+}
+
+template<uint32_t LANES, typename WAIT>
+template<typename HANDLER>
+QCS_INLINE auto qcstudio::tx_lane_set_t<LANES, WAIT>::drain(HANDLER&& _handler, uint64_t _budget) -> uint64_t {
+    // one round over the flagged lanes, starting after the last one drained: the bits above it in its word,
+    // the other words, then the bits up to it
+
+    const auto first_word = cursor_ / 64;
+    const auto after      = cursor_ % 64 == 63 ? 0 : ~0ull << (cursor_ % 64 + 1);
+
+    auto result = uint64_t{0};
+    for (auto step = 0u; step <= WORDS; ++step) {
+        const auto w     = (first_word + step) % WORDS;
+        auto       ready = atomic_ref<uint64_t>(ready_[w]).load(memory_order_acquire);
+        if (step == 0) {
+            ready &= after;
+        } else if (step == WORDS) {
+            ready &= ~after;
+        }
+
+        while (ready) {
+            const auto index = w * 64 + (uint32_t)countr_zero(ready);
+            ready &= ready - 1;
+            result += imp_drain_lane(index, _handler, _budget);
+            cursor_ = index;
+        }
+    }
+    return result;
+}
+
+template<uint32_t LANES, typename WAIT>
+template<typename HANDLER>
+QCS_INLINE auto qcstudio::tx_lane_set_t<LANES, WAIT>::imp_drain_lane(uint32_t _lane, HANDLER& _handler, uint64_t _budget) -> uint64_t {
+    auto& lane  = *lanes_[_lane];
+    auto  count = uint64_t{0};
+    while (count < _budget) {
+        auto tx = tx_read_t(lane);
+        _handler(tx);
+        if (!tx) {
+            break;
+        }
+        ++count;
+    }
+    if (count == _budget) {
+        return count;  // keep the flag, there may be more
+    }
+
+    // maybe empty: clear the flag, then check again as the producer may have published after our last read
+
+    auto       ready = atomic_ref<uint64_t>(ready_[_lane / 64]);
+    const auto bit   = 1ull << (_lane % 64);
+    ready.fetch_and(~bit, memory_order_seq_cst);
+    if (atomic_ref<uint64_t>(lane.status_.tail_).load(memory_order_seq_cst) != atomic_ref<uint64_t>(lane.status_.head_).load(memory_order_relaxed)) {
+        ready.fetch_or(bit, memory_order_relaxed);
+    }
+    return count;
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE auto qcstudio::tx_lane_set_t<LANES, WAIT>::imp_registrations() -> registrations_t& {
+    thread_local auto registrations = registrations_t{};
+    return registrations;
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE void qcstudio::tx_lane_set_t<LANES, WAIT>::imp_release(const registration_t& _registration) {
+    atomic_ref<uint64_t>(_registration.taken->words[_registration.lane / 64]).fetch_and(~(1ull << (_registration.lane % 64)), memory_order_release);
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE qcstudio::tx_lane_set_t<LANES, WAIT>::registrations_t::~registrations_t() {
+    // the thread exits without `leave()`: its lanes go back to their sets (or to nobody, if the sets are gone)
+
+    for (auto& registration : *this) {
+        imp_release(registration);
+    }
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE constexpr auto qcstudio::tx_lane_set_t<LANES, WAIT>::imp_valid_bits(uint32_t _word) -> uint64_t {
+    return (_word + 1 < WORDS || LANES % 64 == 0) ? ~0ull : (1ull << (LANES % 64)) - 1;
+}
+
+template<uint32_t LANES, typename WAIT>
+QCS_INLINE auto qcstudio::read_wait(tx_lane_set_t<LANES, WAIT>& _set, tx_deadline_t _deadline) -> bool {
+    return WAIT::wait(_set.ready_word_, false, _deadline, [&] {
+        for (auto& word : _set.ready_) {
+            if (atomic_ref<uint64_t>(word).load(memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+/*
+    ============
+    Object queue
+    ============
+*/
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::~tx_object_queue_t() {
+    for (auto index = head_; index != tail_; ++index) {
+        imp_slot(index)->~T();
+    }
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+template<typename... ARGS>
+QCS_INLINE auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::emplace(ARGS&&... _args) -> bool {
+    const auto tail = atomic_ref<uint64_t>(tail_).load(memory_order_relaxed);  // we are the producer
+
+    // sync the head if full
+
+    if (tail - cached_head_ == SLOTS) {
+        cached_head_ = atomic_ref<uint64_t>(head_).load(memory_order_acquire);
+        if (tail - cached_head_ == SLOTS) {
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(producer_core_).store(current_core, memory_order_relaxed);
+
+            // yield if consumer is in the same cpu
+
+            if (atomic_ref<int32_t>(consumer_core_).load(memory_order_relaxed) == current_core) {
+                this_thread::yield();
+            }
+            return false;
+        }
+        if (producer_core_ != -1) {
+            atomic_ref<int32_t>(producer_core_).store(-1, memory_order_relaxed);
+        }
+    }
+
+    new (imp_slot(tail)) T(forward<ARGS>(_args)...);
+    atomic_ref<uint64_t>(tail_).store(tail + 1, memory_order_release);
+    WAIT::notify(data_ready_, false);
+    return true;
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::pop() -> optional<T> {
+    auto result = optional<T>{};
+    imp_pop([&result](T& _object) { result.emplace(move(_object)); });
+    return result;
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::pop(T& _item) -> bool {
+    return imp_pop([&_item](T& _object) { _item = move(_object); });
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+template<typename TAKE>
+QCS_INLINE auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::imp_pop(TAKE&& _take) -> bool {
+    const auto head = atomic_ref<uint64_t>(head_).load(memory_order_relaxed);  // we are the consumer
+
+    // sync the tail if empty
+
+    if (head == cached_tail_) {
+        cached_tail_ = atomic_ref<uint64_t>(tail_).load(memory_order_acquire);
+        if (head == cached_tail_) {
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(consumer_core_).store(current_core, memory_order_relaxed);
+
+            // yield if producer is in the same cpu
+
+            if (atomic_ref<int32_t>(producer_core_).load(memory_order_relaxed) == current_core) {
+                this_thread::yield();
+            }
+            return false;
+        }
+        if (consumer_core_ != -1) {
+            atomic_ref<int32_t>(consumer_core_).store(-1, memory_order_relaxed);
+        }
+    }
+
+    // move out and destroy before the slot is handed back to the producer
+
+    auto object = imp_slot(head);
+    _take(*object);
+    object->~T();
+    atomic_ref<uint64_t>(head_).store(head + 1, memory_order_release);
+    WAIT::notify(space_ready_, false);
+    return true;
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE constexpr auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::imp_index(uint64_t _index) -> uint64_t {
+    return _index & MASK;  // compile-time mask, no division
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE auto qcstudio::tx_object_queue_t<T, SLOTS, WAIT>::imp_slot(uint64_t _index) -> T* {
+    return launder(reinterpret_cast<T*>(slots_[imp_index(_index)]));
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE auto qcstudio::write_wait(tx_object_queue_t<T, SLOTS, WAIT>& _queue, tx_deadline_t _deadline) -> bool {
+    const auto tail = atomic_ref<uint64_t>(_queue.tail_).load(memory_order_relaxed);  // we are the producer
+    return WAIT::wait(_queue.space_ready_, false, _deadline, [&] {
+        return tail - atomic_ref<uint64_t>(_queue.head_).load(memory_order_acquire) < SLOTS;
+    });
+}
+
+template<typename T, uint64_t SLOTS, typename WAIT>
+QCS_INLINE auto qcstudio::read_wait(tx_object_queue_t<T, SLOTS, WAIT>& _queue, tx_deadline_t _deadline) -> bool {
+    const auto head = atomic_ref<uint64_t>(_queue.head_).load(memory_order_relaxed);  // we are the consumer
+    return WAIT::wait(_queue.data_ready_, false, _deadline, [&] {
+        return atomic_ref<uint64_t>(_queue.tail_).load(memory_order_acquire) != head;
+    });
+}
+
+/*
+    ================
+    Producer session
+    ================
+*/
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_producer_t<QTYPE>::tx_producer_t(QTYPE& _queue, uint64_t _max_messages, uint64_t _max_bytes)
+    : queue_(_queue), max_messages_(_max_messages), max_bytes_(_max_bytes) {
+    static_assert(!QTYPE::is_multi_producer, "no producer sessions on multi-producer queues");
+    static_assert(!QTYPE::is_work_queue, "no producer sessions on work queues");
+
+    storage_ = queue_.storage_;
+    tail_    = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // we are the producer
+    if constexpr (QTYPE::has_shadows) {
+        cached_head_ = queue_.status_.cached_head_;  // our shadow, transactions sync it when required
+    } else {
+        cached_head_ = queue_.status_.slowest_head(tail_, memory_order_relaxed);  // optimistic guess, transactions sync it when required
+    }
+    capacity_ = queue_.capacity_;
+    ok_       = queue_.is_ok();
+    mirrored_ = queue_.storage_type_ == tx_storage_t::MIRRORED;
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_producer_t<QTYPE>::~tx_producer_t() {
+    flush();
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_producer_t<QTYPE>::flush() {
+    if (pending_messages_ == 0) {
+        return;
+    }
+
+    atomic_ref<uint64_t>(queue_.status_.tail_).store(tail_, memory_order_release);
+    QTYPE::wait_t::notify(queue_.status_.data_ready_, QTYPE::is_shared);
+    if constexpr (QTYPE::is_lane) {
+        queue_.imp_signal();
+    }
+    pending_messages_ = 0;
+    pending_bytes_    = 0;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_producer_t<QTYPE>::queue() -> QTYPE& {
+    return queue_;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_producer_t<QTYPE>::imp_commit(uint64_t _tail, uint64_t _cached_head) {
+    pending_bytes_ += _tail - tail_;
+    pending_messages_++;
+    tail_        = _tail;
+    cached_head_ = _cached_head;
+
+    if ((max_messages_ && pending_messages_ >= max_messages_) || (max_bytes_ && pending_bytes_ >= max_bytes_)) {
+        flush();
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::write_wait(tx_producer_t<QTYPE>& _producer, uint64_t _size, tx_deadline_t _deadline) -> bool {
+    _producer.flush();
+    return write_wait(_producer.queue(), _size, _deadline);
+}
+
+/*
+    ================
+    Consumer session
+    ================
+*/
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_consumer_t<QTYPE>::tx_consumer_t(QTYPE& _queue, uint64_t _max_messages, uint64_t _max_bytes)
+    : queue_(_queue), max_messages_(_max_messages), max_bytes_(_max_bytes) {
+    static_assert(!QTYPE::is_broadcast, "no consumer sessions on broadcast queues");
+    static_assert(!QTYPE::is_work_queue, "no consumer sessions on work queues");
+
+    if (atomic_ref<tx_numa_t::policy_t>(queue_.numa_.policy).load(memory_order_relaxed) == tx_numa_t::policy_t::CONSUMER) {
+        queue_.imp_place_on_consumer();  // the storage lives in the same line, no extra miss
+    }
+
+    storage_ = queue_.storage_;
+    head_    = atomic_ref<uint64_t>(queue_.status_.reader_head(0)).load(memory_order_relaxed);  // we are the consumer
+    if constexpr (QTYPE::has_shadows) {
+        cached_tail_ = queue_.status_.cached_tail_;  // our shadow, transactions sync it when required
+    } else {
+        cached_tail_ = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // optimistic guess, transactions sync it when required
+    }
+    capacity_ = queue_.capacity_;
+    ok_       = queue_.is_ok();
+    mirrored_ = queue_.storage_type_ == tx_storage_t::MIRRORED;
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_consumer_t<QTYPE>::~tx_consumer_t() {
+    flush();
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_consumer_t<QTYPE>::flush() {
+    if (pending_messages_ == 0) {
+        return;
+    }
+
+    atomic_ref<uint64_t>(queue_.status_.reader_head(0)).store(head_, memory_order_release);
+    QTYPE::wait_t::notify(queue_.status_.space_ready_, QTYPE::is_shared);
+    pending_messages_ = 0;
+    pending_bytes_    = 0;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_consumer_t<QTYPE>::queue() -> QTYPE& {
+    return queue_;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_consumer_t<QTYPE>::imp_commit(uint64_t _head, uint64_t _cached_tail) {
+    pending_bytes_ += _head - head_;
+    pending_messages_++;
+    head_        = _head;
+    cached_tail_ = _cached_tail;
+
+    if ((max_messages_ && pending_messages_ >= max_messages_) || (max_bytes_ && pending_bytes_ >= max_bytes_)) {
+        flush();
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::read_wait(tx_consumer_t<QTYPE>& _consumer, uint64_t _size, tx_deadline_t _deadline) -> bool {
+    _consumer.flush();
+    return read_wait(_consumer.queue(), _size, _deadline);
+}
+
+/*
+    =================
+    Write transaction
+    =================
+*/
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_write_t<QTYPE>::tx_write_t(QTYPE& _queue) : queue_(_queue) {
+    static_assert(!QTYPE::is_multi_producer, "multi-producer queues need the size up front: tx_write_t(queue, size)");
+
+    storage_ = queue_.storage_;
+    tail_    = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // relaxed => no sync required as the tail is only modified by the producer (us)
+    if constexpr (QTYPE::has_shadows) {
+        cached_head_ = queue_.status_.cached_head_;  // our shadow, in our line: the head line is only pulled when it runs short
+    } else {
+        cached_head_ = queue_.status_.slowest_head(tail_, memory_order_relaxed);  // optimistic guess, "gimme whatever you have". Later we'll sync if required!
+    }
+    capacity_    = queue_.capacity_;  // copy to favour the data locality
+    invalidated_ = !_queue.is_ok();
+    mirrored_    = queue_.storage_type_ == tx_storage_t::MIRRORED;
+    reservation_ = tail_;
+
+    // work queues: room for the record header, written on commit
+
+    if constexpr (QTYPE::is_work_queue) {
+        if (imp_check_space(QTYPE::HEADER_SIZE)) {
+            imp_advance(QTYPE::HEADER_SIZE);
+        }
+    }
+
+    // latency mode: room for the stamp, written on commit
+
+    if constexpr (QTYPE::has_latency) {
+        if (imp_check_space(STAMP_SIZE)) {
+            imp_advance(STAMP_SIZE);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_write_t<QTYPE>::tx_write_t(QTYPE& _queue, uint64_t _size) : queue_(_queue) {
+    static_assert(QTYPE::is_multi_producer, "sized transactions are for multi-producer queues");
+
+    if (_size) {
+        _size += STAMP_SIZE;  // latency mode: the stamp goes in front of the payload
+    }
+
+    // the record: header, payload and padding
+
+    const auto room = _size ? QTYPE::HEADER_SIZE + QTYPE::imp_padded(_size) : 0;
+
+    storage_     = queue_.storage_;
+    capacity_    = queue_.capacity_;
+    invalidated_ = !_queue.is_ok() || _size > QTYPE::MAX_RECORD_SIZE || room > capacity_;
+    mirrored_    = queue_.storage_type_ == tx_storage_t::MIRRORED;
+    reservation_ = 0;
+
+    // reserve [reservation_, reservation_ + room), the head is reloaded on every attempt as `reserve` may be stale
+
+    auto reserve = atomic_ref<uint64_t>(queue_.reserve_);
+    auto current = reserve.load(memory_order_relaxed);
+    while (!invalidated_ && room) {
+        const auto head = queue_.status_.slowest_head(current, memory_order_acquire);
+        imp_count(&tx_counters_t::syncs, 1);
+        imp_peak(current - head);
+        if (room > capacity_ - (current - head)) {
+            if (const auto latest = reserve.load(memory_order_relaxed); latest != current) {
+                current = latest;
+                continue;
+            }
+            invalidated_ = true;
+
+            // full: yield if consumer is in the same cpu
+
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(queue_.status_.producer_core_).store(current_core, memory_order_relaxed);
+            if (queue_.status_.consumer_on_core(current_core)) {
+                this_thread::yield();
+                imp_count(&tx_counters_t::yields, 1);
+            }
+        } else if (reserve.compare_exchange_weak(current, current + room, memory_order_relaxed)) {
+            reservation_ = current;
+            if (auto prev_core = atomic_ref<int32_t>(queue_.status_.producer_core_).load(memory_order_relaxed); prev_core != -1) {
+                atomic_ref<int32_t>(queue_.status_.producer_core_).store(-1, memory_order_relaxed);
+            }
+            break;
+        }
+    }
+
+    tail_        = reservation_ + (invalidated_ || !_size ? 0 : QTYPE::HEADER_SIZE + STAMP_SIZE);
+    cached_head_ = reservation_ + (invalidated_ || !_size ? 0 : QTYPE::HEADER_SIZE + _size);  // the end of the room we can write
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_write_t<QTYPE>::tx_write_t(tx_producer_t<QTYPE>& _producer) : queue_(_producer.queue_), producer_(&_producer) {
+    // everything comes from the session, no status line is touched
+
+    storage_     = _producer.storage_;
+    tail_        = _producer.tail_;  // it may be ahead of the published one
+    cached_head_ = _producer.cached_head_;
+    capacity_    = _producer.capacity_;
+    invalidated_ = !_producer.ok_;
+    mirrored_    = _producer.mirrored_;
+    reservation_ = tail_;
+
+    if constexpr (QTYPE::has_latency) {
+        if (imp_check_space(STAMP_SIZE)) {
+            imp_advance(STAMP_SIZE);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_write_t<QTYPE>::operator bool() const noexcept {
+    return !invalidated_;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const void* _buffer, uint64_t _size) -> bool {
+    return imp_write(_buffer, _size);
+}
+
+template<typename QTYPE>
+template<typename T>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const T& _item) -> bool {
+    if constexpr (is_same_v<T, string>) {
+        return imp_write(_item.data(), _item.length());
+    } else {
+        static_assert(is_trivially_copyable_v<T>, "only trivially copyable types can be copied as bytes, see tx_object_queue_t");
+        return imp_write(&_item, sizeof(T));
+    }
+}
+
+template<typename QTYPE>
+template<typename T, uint64_t N>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const T (&_array)[N]) -> bool {
+    if constexpr (is_same_v<T, char> || is_same_v<T, wchar_t>) {
+        return N > 1 && imp_write(&_array[0], (N - 1) * sizeof(T));  // no "\0" included
+    } else {
+        return imp_write(&_array[0], N * sizeof(T));
+    }
+}
+
+template<typename QTYPE>
+template<typename FIRST, typename... REST>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::write(const FIRST& _first, REST... _rest) -> enable_if_t<!is_pointer_v<FIRST>, bool> {
+    if constexpr (tx_record_t<FIRST, REST...>::packed) {
+        return imp_write_packed(_first, _rest...);
+    } else {
+        if (!write(_first)) {
+            return false;
+        }
+        return write(_rest...);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::reserve(uint64_t _size) -> tx_span_t<uint8_t> {
+    if (!imp_check_space(_size)) {
+        return {};
+    }
+
+    // hand out the room in place (split in two if it wraps around)
+
+    const auto tail   = tx_offset(tail_, capacity_);
+    auto       result = tx_span_t<uint8_t>{};
+    if (!mirrored_ && (tail + _size) > capacity_) {
+        const auto first_chunk_size = capacity_ - tail;
+        result.first                = {storage_ + tail, first_chunk_size};
+        result.second               = {storage_, _size - first_chunk_size};
+    } else {
+        result.first = {storage_ + tail, _size};
+    }
+
+    imp_advance(_size);
+    return result;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::imp_write(const void* _buffer, uint64_t _size) -> bool {
+    if (!imp_check_space(_size)) {
+        return false;
+    }
+
+    // there is room, hence, write
+
+    const auto tail = tx_offset(tail_, capacity_);
+    if (!mirrored_ && (tail + _size) > capacity_) {
+        const auto first_chunk_size = capacity_ - tail;
+        memops::copy(storage_ + tail, _buffer, /*                        */ first_chunk_size);
+        memops::copy(storage_, /*  */ (uint8_t*)_buffer + first_chunk_size, _size - first_chunk_size);
+        imp_count(&tx_counters_t::wraps, 1);
+    } else {
+        memops::copy(storage_ + tail, _buffer, _size);
+    }
+
+    imp_advance(_size);
+    return true;
+}
+
+template<typename QTYPE>
+template<typename... ARGS>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::imp_write_packed(const ARGS&... _args) -> bool {
+    constexpr auto size = tx_record_t<ARGS...>::size;
+    if (!imp_check_space(size)) {
+        return false;
+    }
+
+    // fixed-size copies straight into the storage, or packed on the stack first if the record wraps around
+
+    const auto tail = tx_offset(tail_, capacity_);
+    if (!mirrored_ && (tail + size) > capacity_) {
+        uint8_t packed[size];
+        auto    dst = packed;
+        ((memcpy(dst, &_args, sizeof(ARGS)), dst += sizeof(ARGS)), ...);
+
+        const auto first_chunk_size = capacity_ - tail;
+        memops::copy(storage_ + tail, packed, /*                        */ first_chunk_size);
+        memops::copy(storage_, /*  */ packed + first_chunk_size, size - first_chunk_size);
+        imp_count(&tx_counters_t::wraps, 1);
+    } else {
+        auto dst = storage_ + tail;
+        ((memcpy(dst, &_args, sizeof(ARGS)), dst += sizeof(ARGS)), ...);
+    }
+
+    imp_advance(size);
+    return true;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_write_t<QTYPE>::imp_check_space(uint64_t _size) -> bool {
+    if (invalidated_) {
+        return false;
+    }
+
+    // multi-producer: only the reserved room
+
+    if constexpr (QTYPE::is_multi_producer) {
+        if (_size > cached_head_ - tail_) {
+            invalidated_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    // work queues: the record size must fit its header, and room for the padding of the record as well
+
+    if constexpr (QTYPE::is_work_queue) {
+        if (_size > QTYPE::HEADER_SIZE + QTYPE::MAX_RECORD_SIZE - (tail_ - reservation_)) {
+            invalidated_ = true;
+            return false;
+        }
+        _size += QTYPE::HEADER_SIZE - 1;
+    }
+
+    auto available_space = capacity_ - (tail_ - cached_head_);
+
+    // sync the head if no space
+
+    if (_size > available_space) {
+        if constexpr (QTYPE::is_work_queue) {
+            queue_.imp_reclaim();  // the head only moves when we reclaim the finished records
+        }
+        cached_head_    = queue_.status_.slowest_head(tail_, memory_order_acquire);
+        available_space = capacity_ - (tail_ - cached_head_);
+        if constexpr (QTYPE::has_shadows) {
+            queue_.status_.cached_head_ = cached_head_;
+        }
+        imp_count(&tx_counters_t::syncs, 1);
+        imp_peak(tail_ - cached_head_);
+        if (_size > available_space) {
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(queue_.status_.producer_core_).store(current_core, memory_order_relaxed);
+
+            // yield if consumer is in the same cpu
+
+            if (queue_.status_.consumer_on_core(current_core)) {
+                this_thread::yield();
+                imp_count(&tx_counters_t::yields, 1);
+            }
+
+            invalidated_ = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_advance(uint64_t _size) {
+    // update the tail properly
+
+    tail_ += _size;
+
+    // reset producer_core_ to -1 only if it was previously set (i.e., not -1)
+
+    if constexpr (QTYPE::is_multi_producer) {
+        return;  // done once, upon reservation
+    }
+
+    if (auto prev_core = atomic_ref<int32_t>(queue_.status_.producer_core_).load(memory_order_relaxed); prev_core != -1) {
+        atomic_ref<int32_t>(queue_.status_.producer_core_).store(-1, memory_order_relaxed);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::invalidate() {
+    invalidated_ = true;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_publish_in_order() {
+    if (cached_head_ == reservation_) {
+        return;  // nothing reserved
+    }
+
+    const auto size     = cached_head_ - reservation_ - QTYPE::HEADER_SIZE;
+    const auto end      = reservation_ + QTYPE::HEADER_SIZE + QTYPE::imp_padded(size);
+    const auto complete = !invalidated_ && tail_ == cached_head_;
+
+    // incomplete: roll back if nobody reserved after us, otherwise publish it as skipped (the consumer steps over it)
+
+    if (!complete) {
+        auto expected = end;
+        if (atomic_ref<uint64_t>(queue_.reserve_).compare_exchange_strong(expected, reservation_, memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    // latency mode: stamped as we commit, the wait for the producers before us is part of the latency
+
+    if constexpr (QTYPE::has_latency) {
+        if (complete) {
+            imp_stamp();
+        }
+    }
+
+    // wait for the producers that reserved before us, then publish (the header before the tail, as in the work queue)
+
+    atomic_ref<uint64_t>(queue_.imp_header(reservation_)).store(QTYPE::imp_pack(size, complete ? QTYPE::state_t::PUBLISHED : QTYPE::state_t::SKIPPED), memory_order_relaxed);
+
+    auto tail = atomic_ref<uint64_t>(queue_.status_.tail_);
+    for (auto spins = 1u; tail.load(memory_order_acquire) != reservation_; ++spins) {
+        if (spins % 64) {
+            _mm_pause();
+        } else {
+            this_thread::yield();
+        }
+    }
+    tail.store(end, memory_order_release);
+    QTYPE::wait_t::notify(queue_.status_.data_ready_, QTYPE::is_shared);
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_publish_record() {
+    if (invalidated_) {
+        return;  // the tail was not published, the header is overwritten by the next record
+    }
+
+    const auto size = tail_ - reservation_ - QTYPE::HEADER_SIZE;
+    if (size == 0) {
+        return;  // empty records are not published
+    }
+
+    // pad the end, then publish the header before the tail (consumers read it once they see the tail)
+
+    tail_ += QTYPE::imp_padded(size) - size;
+    atomic_ref<uint64_t>(queue_.imp_header(reservation_)).store(QTYPE::imp_pack(size, QTYPE::state_t::PUBLISHED), memory_order_relaxed);
+    atomic_ref<uint64_t>(queue_.status_.tail_).store(tail_, memory_order_release);
+    QTYPE::wait_t::notify(queue_.status_.data_ready_, QTYPE::is_shared);
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_count(uint64_t tx_counters_t::*_counter, uint64_t _value) {
+    if constexpr (QTYPE::has_stats) {
+        auto counter = atomic_ref<uint64_t>(queue_.status_.stats_.producer_.*_counter);
+        if constexpr (QTYPE::is_multi_producer) {
+            counter.fetch_add(_value, memory_order_relaxed);  // shared by the producers
+        } else {
+            counter.store(counter.load(memory_order_relaxed) + _value, memory_order_relaxed);  // we are the producer, no RMW required
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_peak(uint64_t _occupancy) {
+    if constexpr (QTYPE::has_stats) {
+        auto high_water = atomic_ref<uint64_t>(queue_.status_.stats_.producer_.high_water);
+        auto current    = high_water.load(memory_order_relaxed);
+        if constexpr (QTYPE::is_multi_producer) {
+            while (_occupancy > current && !high_water.compare_exchange_weak(current, _occupancy, memory_order_relaxed)) {
+            }
+        } else if (_occupancy > current) {
+            high_water.store(_occupancy, memory_order_relaxed);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_write_t<QTYPE>::imp_stamp() {
+    // multi-producer: after the record header
+
+    auto start = reservation_;
+    if constexpr (QTYPE::is_multi_producer) {
+        start += QTYPE::HEADER_SIZE;
+    }
+
+    const auto stamp    = tsc::now();
+    const auto position = tx_offset(start, capacity_);
+    if (!mirrored_ && (position + STAMP_SIZE) > capacity_) {
+        const auto first_chunk_size = capacity_ - position;
+        memcpy(storage_ + position, &stamp, first_chunk_size);
+        memcpy(storage_, (const uint8_t*)&stamp + first_chunk_size, STAMP_SIZE - first_chunk_size);
+    } else {
+        memcpy(storage_ + position, &stamp, STAMP_SIZE);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_write_t<QTYPE>::~tx_write_t() {
+    if constexpr (QTYPE::has_stats) {
+        if (!invalidated_ && (!QTYPE::is_multi_producer || tail_ == cached_head_)) {  // multi-producer: incomplete ones are rolled back or skipped
+            auto start = reservation_ + STAMP_SIZE;
+            if constexpr (QTYPE::is_multi_producer) {
+                start += QTYPE::HEADER_SIZE;
+            }
+            imp_count(&tx_counters_t::committed, 1);
+            imp_count(&tx_counters_t::bytes, tail_ - min(tail_, start));
+        } else {
+            imp_count(&tx_counters_t::invalidated, 1);
+        }
+    }
+
+    if constexpr (QTYPE::is_multi_producer) {
+        imp_publish_in_order();
+        return;
+    }
+
+    if constexpr (QTYPE::is_work_queue) {
+        imp_publish_record();
+        return;
+    }
+
+    // latency mode: stamp it, the stamp alone (empty transaction) is not published
+
+    if constexpr (QTYPE::has_latency) {
+        if (!invalidated_) {
+            if (tail_ == reservation_ + STAMP_SIZE) {
+                return;
+            }
+            imp_stamp();
+        }
+    }
+
+    if (producer_) {
+        if (!invalidated_) {
+            producer_->imp_commit(tail_, cached_head_);
+        } else {
+            producer_->cached_head_ = cached_head_;  // keep the synced head for the next transaction
+            producer_->flush();                      // maybe full: let the consumer see what we have
+        }
+    } else if (!invalidated_) {
+        atomic_ref<uint64_t>(queue_.status_.tail_).store(tail_, memory_order_release);  // TODO: check how to deal with this in IPC we need to use https://learn.microsoft.com/en-us/windows/win32/sync/interlocked-variable-access
+        QTYPE::wait_t::notify(queue_.status_.data_ready_, QTYPE::is_shared);
+        if constexpr (QTYPE::is_lane) {
+            queue_.imp_signal();
+        }
+    }
+}
+
+/*
+    =================
+    read transaction
+    =================
+*/
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_read_t<QTYPE>::tx_read_t(QTYPE& _queue) : tx_read_t(_queue, 0) {
+    static_assert(!QTYPE::is_broadcast, "broadcast queues need the reader: tx_read_t(queue, reader)");
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_read_t<QTYPE>::tx_read_t(QTYPE& _queue, uint32_t _reader) : queue_(_queue), reader_(_reader) {
+    if (atomic_ref<tx_numa_t::policy_t>(queue_.numa_.policy).load(memory_order_relaxed) == tx_numa_t::policy_t::CONSUMER) {
+        queue_.imp_place_on_consumer();  // the storage lives in the same line, no extra miss
+    }
+
+    // broadcast queues: an unknown reader gets an invalidated transaction (no head to touch)
+
+    auto known_reader = true;
+    if constexpr (QTYPE::is_broadcast) {
+        known_reader = _reader < QTYPE::readers;
+    }
+
+    storage_ = queue_.storage_;
+    head_    = known_reader ? atomic_ref<uint64_t>(queue_.status_.reader_head(reader_)).load(memory_order_relaxed) : 0;  // relaxed => no sync required as the head is only modified by the consumer (us)
+    if constexpr (QTYPE::has_shadows) {
+        cached_tail_ = queue_.status_.cached_tail_;  // our shadow, in our line: the tail line is only pulled when it runs short
+    } else {
+        cached_tail_ = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_relaxed);  // optimistic guess, "gimme whatever you have". Later we'll sync if required!
+    }
+    capacity_    = queue_.capacity_;  // copy to favour the data locality
+    invalidated_ = !_queue.is_ok() || !known_reader;
+    mirrored_    = queue_.storage_type_ == tx_storage_t::MIRRORED;
+    record_      = head_;
+    claimed_     = false;
+    rescued_     = false;
+
+    if constexpr (QTYPE::is_work_queue) {
+        imp_claim();
+    }
+
+    if constexpr (QTYPE::is_multi_producer) {
+        imp_frame();
+    }
+
+    // latency mode: skip the stamp, read back on commit
+
+    if constexpr (QTYPE::has_latency) {
+        if (imp_check_data(STAMP_SIZE)) {
+            imp_advance(STAMP_SIZE);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_read_t<QTYPE>::tx_read_t(tx_consumer_t<QTYPE>& _consumer) : queue_(_consumer.queue_), consumer_(&_consumer) {
+    // everything comes from the session, no status line is touched
+
+    storage_     = _consumer.storage_;
+    head_        = _consumer.head_;  // it may be ahead of the published one
+    cached_tail_ = _consumer.cached_tail_;
+    capacity_    = _consumer.capacity_;
+    invalidated_ = !_consumer.ok_;
+    mirrored_    = _consumer.mirrored_;
+    record_      = head_;
+    claimed_     = false;
+    rescued_     = false;
+
+    if constexpr (QTYPE::is_multi_producer) {
+        imp_frame();
+    }
+
+    if constexpr (QTYPE::has_latency) {
+        if (imp_check_data(STAMP_SIZE)) {
+            imp_advance(STAMP_SIZE);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_read_t<QTYPE>::operator bool() const noexcept {
+    return !invalidated_;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read(void* _buffer, uint64_t _size) -> bool {
+    return imp_read(_buffer, _size);
+}
+
+template<typename QTYPE>
+template<typename T>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read(T& _item) -> bool {
+    static_assert(is_trivially_copyable_v<T>, "only trivially copyable types can be copied as bytes, see tx_object_queue_t");
+    return imp_read(&_item, sizeof(T));
+}
+
+// Helper function to convert a pointer to a reference
+
+template<typename QTYPE>
+template<typename... ARGS>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::read() -> enable_if_t<conjunction_v<is_default_constructible<ARGS>...>, tuple<ARGS...>> {
+    if constexpr (sizeof...(ARGS) > 0) {
+        auto temp = tuple<ARGS...>{};
+        if constexpr (tx_record_t<ARGS...>::packed) {
+            if (auto all_read = apply([this](auto&... _args) { return this->imp_read_packed(_args...); }, temp)) {
+                return temp;
+            }
+        } else {
+            if (auto all_read = apply([this](auto&&... _args) { return (this->read(_args) && ...); }, temp)) {
+                return temp;
+            }
+        }
+    }
+    return {};
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::peek(uint64_t _size) -> tx_span_t<const uint8_t> {
+    if (!imp_check_data(_size)) {
+        return {};
+    }
+
+    // hand out the data in place (split in two if it wraps around)
+
+    const auto head   = tx_offset(head_, capacity_);
+    auto       result = tx_span_t<const uint8_t>{};
+    if (!mirrored_ && (head + _size) > capacity_) {
+        const auto first_chunk_size = capacity_ - head;
+        result.first                = {storage_ + head, first_chunk_size};
+        result.second               = {storage_, _size - first_chunk_size};
+    } else {
+        result.first = {storage_ + head, _size};
+    }
+
+    return result;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::skip(uint64_t _size) -> bool {
+    if (!imp_check_data(_size)) {
+        return false;
+    }
+
+    imp_advance(_size);
+    return true;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::imp_read(void* _buffer, uint64_t _size) -> bool {
+    if (!imp_check_data(_size)) {
+        return false;
+    }
+
+    // there is data, hence, read
+
+    const auto head = tx_offset(head_, capacity_);
+    if (!mirrored_ && (head + _size) > capacity_) {
+        const auto first_chunk_size = capacity_ - head;
+        memops::copy_out(_buffer, /*                        */ storage_ + head, first_chunk_size);
+        memops::copy_out((uint8_t*)_buffer + first_chunk_size, storage_, /*  */ _size - first_chunk_size);
+        imp_count(&tx_counters_t::wraps, 1);
+    } else {
+        memops::copy_out(_buffer, storage_ + head, _size);
+    }
+
+    imp_advance(_size);
+    return true;
+}
+
+template<typename QTYPE>
+template<typename... ARGS>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::imp_read_packed(ARGS&... _args) -> bool {
+    constexpr auto size = tx_record_t<ARGS...>::size;
+    if (!imp_check_data(size)) {
+        return false;
+    }
+
+    // fixed-size copies straight from the storage, or unpacked from the stack if the record wraps around
+
+    const auto head = tx_offset(head_, capacity_);
+    if (!mirrored_ && (head + size) > capacity_) {
+        uint8_t    packed[size];
+        const auto first_chunk_size = capacity_ - head;
+        memops::copy_out(packed, /*                        */ storage_ + head, first_chunk_size);
+        memops::copy_out(packed + first_chunk_size, storage_, /*  */ size - first_chunk_size);
+        imp_count(&tx_counters_t::wraps, 1);
+
+        const uint8_t* src = packed;
+        ((memcpy(&_args, src, sizeof(ARGS)), src += sizeof(ARGS)), ...);
+    } else {
+        const uint8_t* src = storage_ + head;
+        ((memcpy(&_args, src, sizeof(ARGS)), src += sizeof(ARGS)), ...);
+    }
+
+    imp_advance(size);
+    return true;
+}
+
+template<typename QTYPE>
+QCS_INLINE auto qcstudio::tx_read_t<QTYPE>::imp_check_data(uint64_t _size) -> bool {
+    if (invalidated_) {
+        return false;
+    }
+
+    // work queues: only the claimed record
+
+    if constexpr (QTYPE::is_work_queue) {
+        if (_size > cached_tail_ - head_) {
+            invalidated_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    // multi-producer: only the framed record (the header is ours until we commit)
+
+    if constexpr (QTYPE::is_multi_producer) {
+        if (claimed_) {
+            const auto end = record_ + (queue_.imp_header(record_ - QTYPE::HEADER_SIZE) & 0xFFFF'FFFF);
+            if (_size > end - head_) {
+                invalidated_ = true;
+                return false;
+            }
+            return true;
+        }
+    }
+
+    auto available_data = cached_tail_ - head_;
+
+    // sync the tail if no data
+
+    if (_size > available_data) {
+        cached_tail_   = atomic_ref<uint64_t>(queue_.status_.tail_).load(memory_order_acquire);
+        available_data = cached_tail_ - head_;
+        if constexpr (QTYPE::has_shadows) {
+            queue_.status_.cached_tail_ = cached_tail_;
+        }
+        imp_count(&tx_counters_t::syncs, 1);
+        imp_peak(cached_tail_ - head_);
+        if (_size > available_data) {
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(queue_.status_.reader_core(reader_)).store(current_core, memory_order_relaxed);
+
+            // yield if producer is in the same cpu
+
+            int producer_core = atomic_ref<int32_t>(queue_.status_.producer_core_).load(memory_order_relaxed);
+            if (producer_core != -1 && producer_core == current_core) {
+                this_thread::yield();
+                imp_count(&tx_counters_t::yields, 1);
+            }
+
+            invalidated_ = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_advance(uint64_t _size) {
+    // update the head properly
+
+    head_ += _size;
+
+    // reset consumer_core_ to -1 only if it was previously set (i.e., not -1)
+
+    if constexpr (QTYPE::is_work_queue) {
+        return;  // done once, upon claim
+    }
+
+    if (auto prev_core = atomic_ref<int32_t>(queue_.status_.reader_core(reader_)).load(memory_order_relaxed); prev_core != -1) {
+        atomic_ref<int32_t>(queue_.status_.reader_core(reader_)).store(-1, memory_order_relaxed);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::invalidate() {
+    invalidated_ = true;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_claim() {
+    if (invalidated_) {
+        return;
+    }
+
+    auto& status = queue_.status_;
+
+    // released records first (rare): they sit between the head and the claim, the head is validated after reading
+    // each header as the producer may reclaim and reuse that space meanwhile
+
+    if (atomic_ref<uint64_t>(status.released_).load(memory_order_relaxed) != 0) {
+        const auto head  = atomic_ref<uint64_t>(status.head_).load(memory_order_acquire);
+        const auto claim = atomic_ref<uint64_t>(status.claim_).load(memory_order_acquire);
+        for (auto position = head; position != claim;) {
+            auto header = atomic_ref<uint64_t>(queue_.imp_header(position)).load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_ref<uint64_t>(status.head_).load(memory_order_relaxed) != head) {
+                break;  // stale, try a new record
+            }
+
+            const auto size = header & 0xFFFF'FFFF;
+            if ((typename QTYPE::state_t)(header >> 32) == QTYPE::state_t::RELEASED &&
+                atomic_ref<uint64_t>(queue_.imp_header(position)).compare_exchange_strong(header, QTYPE::imp_pack(size, QTYPE::state_t::CLAIMED), memory_order_acquire)) {
+                atomic_ref<uint64_t>(status.released_).fetch_sub(1, memory_order_relaxed);
+                record_      = position;
+                head_        = position + QTYPE::HEADER_SIZE;
+                cached_tail_ = head_ + size;
+                claimed_     = true;
+                rescued_     = true;
+                return;
+            }
+            position += QTYPE::HEADER_SIZE + QTYPE::imp_padded(size);
+        }
+    }
+
+    // claim the next record, the header is valid as long as the claim did not move (checked by the CAS)
+
+    auto claim   = atomic_ref<uint64_t>(status.claim_);
+    auto current = claim.load(memory_order_acquire);
+    while (true) {
+        const auto tail = atomic_ref<uint64_t>(status.tail_).load(memory_order_acquire);
+        if (tail == current) {
+            invalidated_ = true;
+
+            // empty: yield if producer is in the same cpu
+
+            auto current_core = cpu::current();
+            atomic_ref<int32_t>(status.consumer_core_).store(current_core, memory_order_relaxed);
+            if (atomic_ref<int32_t>(status.producer_core_).load(memory_order_relaxed) == current_core) {
+                this_thread::yield();
+            }
+            return;
+        }
+
+        const auto size = atomic_ref<uint64_t>(queue_.imp_header(current)).load(memory_order_relaxed) & 0xFFFF'FFFF;
+        if (claim.compare_exchange_weak(current, current + QTYPE::HEADER_SIZE + QTYPE::imp_padded(size), memory_order_acquire)) {
+            record_      = current;
+            head_        = current + QTYPE::HEADER_SIZE;
+            cached_tail_ = head_ + size;
+            claimed_     = true;
+            if (auto prev_core = atomic_ref<int32_t>(status.consumer_core_).load(memory_order_relaxed); prev_core != -1) {
+                atomic_ref<int32_t>(status.consumer_core_).store(-1, memory_order_relaxed);
+            }
+            return;
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_finish() {
+    if (!claimed_) {
+        return;
+    }
+
+    auto&      status = queue_.status_;
+    auto       header = atomic_ref<uint64_t>(queue_.imp_header(record_));
+    const auto size   = cached_tail_ - record_ - QTYPE::HEADER_SIZE;
+
+    // commit: done, the producer reclaims it
+
+    if (!invalidated_) {
+        header.store(QTYPE::imp_pack(size, QTYPE::state_t::DONE), memory_order_release);
+        QTYPE::wait_t::notify(status.space_ready_, QTYPE::is_shared);
+        return;
+    }
+
+    // invalidate: roll the claim back if nobody claimed after us, otherwise flag it for the next consumers
+
+    auto expected = record_ + QTYPE::HEADER_SIZE + QTYPE::imp_padded(size);
+    if (rescued_ || !atomic_ref<uint64_t>(status.claim_).compare_exchange_strong(expected, record_, memory_order_relaxed)) {
+        header.store(QTYPE::imp_pack(size, QTYPE::state_t::RELEASED), memory_order_release);
+        atomic_ref<uint64_t>(status.released_).fetch_add(1, memory_order_release);
+    }
+    QTYPE::wait_t::notify(status.data_ready_, QTYPE::is_shared);
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_frame() {
+    // multi-producer: step over the skipped records up to the first published one, which bounds the transaction
+
+    const auto start = head_;
+    while (imp_check_data(QTYPE::HEADER_SIZE)) {
+        const auto header = atomic_ref<uint64_t>(queue_.imp_header(head_)).load(memory_order_relaxed);  // written before the tail we acquired
+        if ((typename QTYPE::state_t)(header >> 32) == QTYPE::state_t::PUBLISHED) {
+            claimed_ = true;
+            break;
+        }
+        head_ += QTYPE::HEADER_SIZE + QTYPE::imp_padded(header & 0xFFFF'FFFF);
+    }
+
+    // the skipped ones are consumed whatever happens to this transaction
+
+    if (head_ != start) {
+        imp_consume(head_);
+    }
+    if (claimed_) {
+        head_ += QTYPE::HEADER_SIZE;
+    }
+    record_ = head_;
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_consume(uint64_t _head) {
+    if (consumer_) {
+        consumer_->imp_commit(_head, cached_tail_);
+    } else {
+        atomic_ref<uint64_t>(queue_.status_.reader_head(reader_)).store(_head, memory_order_release);
+        QTYPE::wait_t::notify(queue_.status_.space_ready_, QTYPE::is_shared);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_count(uint64_t tx_counters_t::*_counter, uint64_t _value) {
+    if constexpr (QTYPE::has_stats) {
+        auto counter = atomic_ref<uint64_t>(queue_.status_.stats_.consumer_.*_counter);
+        counter.store(counter.load(memory_order_relaxed) + _value, memory_order_relaxed);  // we are the consumer, no RMW required
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_peak(uint64_t _occupancy) {
+    if constexpr (QTYPE::has_stats) {
+        if (auto high_water = atomic_ref<uint64_t>(queue_.status_.stats_.consumer_.high_water); _occupancy > high_water.load(memory_order_relaxed)) {
+            high_water.store(_occupancy, memory_order_relaxed);
+        }
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE void qcstudio::tx_read_t<QTYPE>::imp_record_latency() {
+    auto       stamp    = uint64_t{0};
+    const auto position = tx_offset(record_, capacity_);
+    if (!mirrored_ && (position + STAMP_SIZE) > capacity_) {
+        const auto first_chunk_size = capacity_ - position;
+        memcpy(&stamp, storage_ + position, first_chunk_size);
+        memcpy((uint8_t*)&stamp + first_chunk_size, storage_, STAMP_SIZE - first_chunk_size);
+    } else {
+        memcpy(&stamp, storage_ + position, STAMP_SIZE);
+    }
+
+    if (const auto now = tsc::now(); now > stamp) {
+        queue_.status_.stats_.latency_.record(now - stamp);
+    }
+}
+
+template<typename QTYPE>
+QCS_INLINE qcstudio::tx_read_t<QTYPE>::~tx_read_t() {
+    if constexpr (QTYPE::has_stats) {
+        if (!invalidated_) {
+            imp_count(&tx_counters_t::committed, 1);
+            imp_count(&tx_counters_t::bytes, head_ - record_ - STAMP_SIZE);
+        } else {
+            imp_count(&tx_counters_t::invalidated, 1);
+        }
+    }
+
+    if constexpr (QTYPE::is_work_queue) {
+        imp_finish();
+        return;
+    }
+
+    if constexpr (QTYPE::has_latency) {
+        if (!invalidated_) {
+            imp_record_latency();
+        }
+    }
+
+    // multi-producer: the whole record is consumed, padding included
+
+    if constexpr (QTYPE::is_multi_producer) {
+        if (!invalidated_) {
+            head_ = record_ + QTYPE::imp_padded(queue_.imp_header(record_ - QTYPE::HEADER_SIZE) & 0xFFFF'FFFF);
+        }
+    }
+
+    if (consumer_) {
+        if (!invalidated_) {
+            consumer_->imp_commit(head_, cached_tail_);
+        } else {
+            consumer_->cached_tail_ = cached_tail_;  // keep the synced tail for the next transaction
+            consumer_->flush();                      // maybe empty: let the producer reuse what we consumed
+        }
+    } else if (!invalidated_) {
+        atomic_ref<uint64_t>(queue_.status_.reader_head(reader_)).store(head_, memory_order_release);
+        QTYPE::wait_t::notify(queue_.status_.space_ready_, QTYPE::is_shared);
     }
 }
 
@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "objects"
+    kind      "ConsoleApp"
+    files     { "utests/objects/*", "utests/common/*.h", "utests/common/*.cpp", "include/*.h", "include/*.inl" }
@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "pingpong"
+    kind      "ConsoleApp"
+    files     { "utests/pingpong/*", "utests/common/*.h", "utests/common/*.inl", "utests/common/*.cpp", "include/*.h", "include/*.inl" }
@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "stats"
+    kind      "ConsoleApp"
+    files     { "utests/stats/*", "utests/common/*.h", "utests/common/*.cpp", "include/*.h", "include/*.inl" }
@@ -0,0 +1,306 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "shared-memory.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// local types and functions
+
+namespace {
+
+    struct options_t {
+        vector<string> names;
+        milliseconds   interval   = 1s;
+        uint64_t       iterations = 0;  // 0: forever
+        seconds        stall      = 5s;
+        string         prometheus;  // file rewritten on every sample (empty: none)
+    };
+
+    struct rates_t {
+        double bytes[2]     = {};  // producer, consumer
+        double messages[2]  = {};
+        double failed[2]    = {};
+        bool   stalled      = false;
+        double stalled_secs = 0.0;
+    };
+
+    // one attached segment: reopened and re-validated until the queue shows up in it
+
+    struct segment_t {
+        string                    name;
+        unique_ptr<shared_memory> memory;
+        tx_monitor_t              monitor = tx_monitor_t(nullptr);
+        tx_sample_t               last    = {};  // the sample shown
+        rates_t                   rates   = {};  // from the sample before
+        steady_clock::time_point  last_time;
+        steady_clock::time_point  head_moved;  // last time the consumer made progress
+    };
+
+    auto parse(int _argc, const char* _argv[], options_t& _options) -> bool;
+    void usage();
+    auto attach(segment_t& _segment) -> bool;
+    void measure(segment_t& _segment, steady_clock::time_point _now, seconds _stall);
+    void print(const segment_t& _segment);
+    auto write_prometheus(const string& _path, const vector<segment_t>& _segments) -> bool;
+
+}
+
+// main procedure
+//
+// Attaches read-only to the named shared memory segments of `tx_queue_mp_t` queues built with a stats policy
+// (`tx_stats_on_t` or `tx_stats_latency_t`) and shows, every interval:
+// ● occupancy (now and high-water mark) against the capacity
+// ● per side: bytes/s, messages/s and failed transactions/s (from two consecutive samples)
+// ● a stalled consumer: data pending and its head did not move for the stall threshold
+// ● latency percentiles, if the queue keeps a histogram
+//
+// usage: txq-top [-i ms] [-n iterations] [-s stall_secs] [-p metrics.prom] segment...
+//
+// With `-p` every sample is also written to a Prometheus text-format file (through a temporary and a rename, so that
+// a node exporter textfile collector never reads half a file)
+
+auto main(int _argc, const char* _argv[]) -> int {
+    auto options = options_t{};
+    if (!parse(_argc, _argv, options)) {
+        usage();
+        return -1;
+    }
+
+#if _WIN32
+    // ANSI sequences to redraw in place
+
+    if (auto console = GetStdHandle(STD_OUTPUT_HANDLE); console != INVALID_HANDLE_VALUE) {
+        auto mode = DWORD{0};
+        if (GetConsoleMode(console, &mode)) {
+            SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        }
+    }
+#endif
+
+    auto segments = vector<segment_t>(options.names.size());
+    for (auto i = size_t{0}; i < segments.size(); ++i) {
+        segments[i].name = options.names[i];
+    }
+
+    for (auto iteration = uint64_t{0}; !options.iterations || iteration < options.iterations; ++iteration) {
+        if (iteration) {
+            this_thread::sleep_for(options.interval);
+        }
+
+        // compose the whole screen first, then redraw at once
+
+        const auto now    = steady_clock::now();
+        auto       screen = ostringstream{};
+        auto       buffer = cout.rdbuf(screen.rdbuf());
+
+        cout << "\x1b[H\x1b[2J== txq-top: " << segments.size() << " queue(s), every " << options.interval.count() << " ms\n\n";
+        for (auto& segment : segments) {
+            if (!attach(segment)) {
+                cout << "  " << segment.name << ": waiting for the segment and a queue with stats\n\n";
+                continue;
+            }
+            measure(segment, now, options.stall);
+            print(segment);
+        }
+
+        cout.rdbuf(buffer);
+        cout << screen.str() << flush;
+
+        if (!options.prometheus.empty() && !write_prometheus(options.prometheus, segments)) {
+            cout << "Error: cannot write " << options.prometheus << "\n";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+namespace {
+
+    auto parse(int _argc, const char* _argv[], options_t& _options) -> bool {
+        for (auto i = 1; i < _argc; ++i) {
+            const auto arg       = string_view(_argv[i]);
+            const auto has_value = i + 1 < _argc;
+            if (arg == "-i" && has_value) {
+                _options.interval = milliseconds(max(atoll(_argv[++i]), 10ll));
+            } else if (arg == "-n" && has_value) {
+                _options.iterations = (uint64_t)atoll(_argv[++i]);
+            } else if (arg == "-s" && has_value) {
+                _options.stall = seconds(max(atoll(_argv[++i]), 1ll));
+            } else if (arg == "-p" && has_value) {
+                _options.prometheus = _argv[++i];
+            } else if (arg.starts_with("-")) {
+                return false;
+            } else {
+                _options.names.emplace_back(arg);
+            }
+        }
+        return !_options.names.empty();
+    }
+
+    void usage() {
+        cout << "usage: txq-top [-i ms] [-n iterations] [-s stall_secs] [-p metrics.prom] segment...\n"
+                "  -i  sampling interval in milliseconds (default 1000)\n"
+                "  -n  number of samples, then exit (default: until killed)\n"
+                "  -s  seconds without consumer progress, with data pending, to flag a stall (default 5)\n"
+                "  -p  also write every sample to this Prometheus text-format file\n";
+    }
+
+    auto attach(segment_t& _segment) -> bool {
+        // the segment may not exist yet, and the queue may not have been constructed on it yet
+
+        if (_segment.monitor) {
+            return true;
+        }
+        if (!_segment.memory || !**_segment.memory) {
+            const auto name = wstring(_segment.name.begin(), _segment.name.end());
+            _segment.memory = make_unique<shared_memory>(name.c_str(), 0, 0, false, false, false, true);
+            if (!**_segment.memory) {
+                return false;
+            }
+        }
+        _segment.monitor = tx_monitor_t((const uint8_t*)**_segment.memory);
+        if (!_segment.monitor) {
+            return false;
+        }
+        _segment.last       = _segment.monitor.sample();
+        _segment.last_time  = steady_clock::now();
+        _segment.head_moved = _segment.last_time;
+        return true;
+    }
+
+    void measure(segment_t& _segment, steady_clock::time_point _now, seconds _stall) {
+        const auto sample  = _segment.monitor.sample();
+        const auto elapsed = duration<double>(_now - _segment.last_time).count();
+        auto&      result  = _segment.rates;
+        if (elapsed > 0.0) {
+            const tx_counters_t* now[2]    = {&sample.stats.producer, &sample.stats.consumer};
+            const tx_counters_t* before[2] = {&_segment.last.stats.producer, &_segment.last.stats.consumer};
+            for (auto side = 0; side < 2; ++side) {
+                result.bytes[side]    = (double)(now[side]->bytes - before[side]->bytes) / elapsed;
+                result.messages[side] = (double)(now[side]->committed - before[side]->committed) / elapsed;
+                result.failed[side]   = (double)(now[side]->invalidated - before[side]->invalidated) / elapsed;
+            }
+        }
+
+        // the consumer is stalled if it has work and did not take any of it for a while (the producer may just be idle)
+
+        if (sample.head != _segment.last.head || sample.tail == sample.head) {
+            _segment.head_moved = _now;
+        }
+        result.stalled_secs = duration<double>(_now - _segment.head_moved).count();
+        result.stalled      = _now - _segment.head_moved >= _stall;
+
+        _segment.last      = sample;
+        _segment.last_time = _now;
+    }
+
+    void print(const segment_t& _segment) {
+        const auto& sample    = _segment.last;
+        const auto& rates     = _segment.rates;
+        const auto  capacity  = _segment.monitor.capacity();
+        const auto  occupancy = sample.tail - sample.head;
+        const auto  percent   = [&](uint64_t _bytes) { return capacity ? (double)_bytes * 100.0 / (double)capacity : 0.0; };
+        const auto  high      = max(sample.stats.producer.high_water, sample.stats.consumer.high_water);
+
+        cout << "  " << _segment.name << " | capacity " << format_size(capacity)                                                        //
+             << " | occupancy " << fixed << setprecision(1) << setw(5) << percent(occupancy) << "% (" << format_size(occupancy) << ")"  //
+             << " | high-water " << setw(5) << percent(high) << "%"                                                                     //
+             << " | " << (rates.stalled ? "CONSUMER STALLED for " + to_string((uint64_t)rates.stalled_secs) + " s" : string("ok")) << "\n";
+
+        const char* sides[2] = {"producer", "consumer"};
+        for (auto side = 0; side < 2; ++side) {
+            cout << "    " << sides[side] << " | " << setw(14) << format_size((uint64_t)rates.bytes[side]) << "/s"  //
+                 << " | " << setprecision(0) << setw(12) << rates.messages[side] << " msg/s"                          //
+                 << " | " << setw(10) << rates.failed[side] << " failed tx/s\n";
+        }
+
+        if (_segment.monitor.has_latency()) {
+            const auto& latency = sample.latency;
+            cout << "    latency  | records " << latency.count << setprecision(0)  //
+                 << " | p50 " << latency.p50 << " ns | p99 " << latency.p99 << " ns | p99.9 " << latency.p999 << " ns | max " << latency.max << " ns\n";
+        }
+        cout << "\n";
+    }
+
+    auto write_prometheus(const string& _path, const vector<segment_t>& _segments) -> bool {
+        // the samples of a metric go together, after its type line; counters are monotonic (rates are for the
+        // scraper to compute), gauges are the instant values
+
+        auto text   = ostringstream{};
+        auto metric = [&](const char* _name, const char* _type, auto _value) {
+            text << "# TYPE " << _name << " " << _type << "\n";
+            for (const auto& segment : _segments) {
+                if (segment.monitor) {
+                    _value(segment, "{queue=\"" + segment.name + "\"");
+                }
+            }
+        };
+        auto gauge = [&](const char* _name, auto _value) {
+            metric(_name, "gauge", [&](const segment_t& _segment, const string& _labels) { text << _name << _labels << "} " << _value(_segment) << "\n"; });
+        };
+        auto sides = [&](const char* _name, const char* _type, uint64_t tx_counters_t::*_counter) {
+            metric(_name, _type, [&](const segment_t& _segment, const string& _labels) {
+                text << _name << _labels << ",side=\"producer\"} " << _segment.last.stats.producer.*_counter << "\n";
+                text << _name << _labels << ",side=\"consumer\"} " << _segment.last.stats.consumer.*_counter << "\n";
+            });
+        };
+
+        gauge("txq_capacity_bytes", [](const segment_t& _segment) { return _segment.monitor.capacity(); });
+        gauge("txq_occupancy_bytes", [](const segment_t& _segment) { return _segment.last.tail - _segment.last.head; });
+        gauge("txq_consumer_stalled", [](const segment_t& _segment) { return _segment.rates.stalled ? 1 : 0; });
+        sides("txq_high_water_bytes", "gauge", &tx_counters_t::high_water);
+        sides("txq_committed_total", "counter", &tx_counters_t::committed);
+        sides("txq_invalidated_total", "counter", &tx_counters_t::invalidated);
+        sides("txq_bytes_total", "counter", &tx_counters_t::bytes);
+        sides("txq_syncs_total", "counter", &tx_counters_t::syncs);
+        sides("txq_wraps_total", "counter", &tx_counters_t::wraps);
+        sides("txq_yields_total", "counter", &tx_counters_t::yields);
+        metric("txq_latency_ns", "summary", [&](const segment_t& _segment, const string& _labels) {
+            if (const auto& latency = _segment.last.latency; _segment.monitor.has_latency()) {
+                text << "txq_latency_ns" << _labels << ",quantile=\"0.5\"} " << latency.p50 << "\n";
+                text << "txq_latency_ns" << _labels << ",quantile=\"0.99\"} " << latency.p99 << "\n";
+                text << "txq_latency_ns" << _labels << ",quantile=\"0.999\"} " << latency.p999 << "\n";
+                text << "txq_latency_ns" << _labels << ",quantile=\"1\"} " << latency.max << "\n";
+                text << "txq_latency_ns_count" << _labels << "} " << latency.count << "\n";
+            }
+        });
+
+        // through a temporary file and a rename, the collector never sees half of it
+
+        const auto temporary = _path + ".tmp";
+        {
+            auto file = ofstream(temporary, ios::binary | ios::trunc);
+            if (!(file << text.str())) {
+                return false;
+            }
+        }
+        auto error = error_code{};
+        filesystem::rename(temporary, _path, error);
+        return !error;
+    }
+
+}  // namespace
@@ -0,0 +1,131 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages   = uint64_t{5'000'000};
+constexpr auto k_queue_size = (uint64_t)1_MiB;
+constexpr auto k_batch      = uint64_t{64};  // messages per publication in batched mode
+
+// local tests
+
+namespace {
+
+    template<uint64_t SIZE>
+    auto transmision(uint64_t _batch) -> int64_t;  // _batch = 0 => plain transactions
+
+    template<uint64_t SIZE>
+    void report();
+
+}
+
+// main procedure
+//
+// Producer and consumer threads exchange small fixed-size messages:
+// ● plain transactions: reload the indices and publish on every message
+// ● sessions publishing every message: the indices are cached across transactions
+// ● sessions publishing every `k_batch` messages
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << ", queue size: " << format_size(k_queue_size) << ", batch: " << k_batch << "\n\n";
+
+    report<16>();
+    report<32>();
+    report<64>();
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    template<uint64_t SIZE>
+    auto transmision(uint64_t _batch) -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto message = array<uint8_t, SIZE>{};
+        auto errors  = uint64_t{0};
+
+        const auto start_time = high_resolution_clock::now();
+
+        auto consumer = thread([&]() {
+            auto received = array<uint8_t, SIZE>{};
+            auto session  = tx_consumer_t(queue, _batch);
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                if (_batch) {
+                    if (auto tx = tx_read_t(session); tx.read(received)) {
+                        errors += memcmp(received.data(), &i, sizeof(i)) != 0;
+                        ++i;
+                    }
+                } else {
+                    if (auto tx = tx_read_t(queue); tx.read(received)) {
+                        errors += memcmp(received.data(), &i, sizeof(i)) != 0;
+                        ++i;
+                    }
+                }
+            }
+        });
+
+        {
+            auto session = tx_producer_t(queue, _batch);
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                memcpy(message.data(), &i, sizeof(i));
+                if (_batch) {
+                    if (auto tx = tx_write_t(session); tx.write(message)) {
+                        ++i;
+                    }
+                } else {
+                    if (auto tx = tx_write_t(queue); tx.write(message)) {
+                        ++i;
+                    }
+                }
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    template<uint64_t SIZE>
+    void report() {
+        const auto plain_ns   = transmision<SIZE>(0);
+        const auto session_ns = transmision<SIZE>(1);
+        const auto batched_ns = transmision<SIZE>(k_batch);
+        if (plain_ns < 0 || session_ns < 0 || batched_ns < 0) {
+            cout << "Error: transmission failed for " << SIZE << " byte messages\n";
+            return;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  message size " << setw(3) << SIZE << " bytes"                                  //
+             << " | plain " << fixed << setprecision(2) << setw(8) << rate(plain_ns) << " Mmsg/s"  //
+             << " | session " << setw(8) << rate(session_ns) << " Mmsg/s"                        //
+             << " | batched " << setw(8) << rate(batched_ns) << " Mmsg/s"                        //
+             << " | speedup x" << (double)plain_ns / (double)session_ns << " / x" << (double)plain_ns / (double)batched_ns << "\n";
+    }
+
+}  // namespace
@@ -0,0 +1,465 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+#include "utest_jobs.h"
+
+// C++
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_source_size = (uint64_t)16_MiB;  // random payload, sent over and over
+constexpr auto k_sizes_count = size_t{4096};      // chunk sizes drawn before a run (no random generator in the loop)
+
+// local types and functions
+
+namespace {
+
+    struct chunks_t {
+        uint64_t min, max;  // uniform in [min, max], fixed when both are equal
+    };
+
+    struct placement_t {
+        int producer = -1, consumer = -1;  // cores (-1: left to the scheduler)
+    };
+
+    struct options_t {
+        vector<uint64_t>      queue_sizes   = {4_KiB, 16_KiB, 64_KiB, 256_KiB, 1_MiB};
+        vector<chunks_t>      chunks        = {{16, 16}, {256, 256}, {4_KiB, 4_KiB}, {147, 8_KiB}};
+        vector<placement_t>   placements    = {{}, {0, 1}};
+        vector<everification> verifications = {NONE};
+        uint32_t              repeats       = 5;
+        uint64_t              bytes         = 256_MiB;  // payload per run
+        string                output;                   // .json: JSON, anything else: CSV (empty: none)
+    };
+
+    struct run_t {
+        int64_t  ns            = -1;  // producer start to consumer end, -1 on error
+        uint64_t messages      = 0;
+        uint64_t write_retries = 0;
+        uint64_t read_retries  = 0;
+    };
+
+    struct point_t {
+        uint64_t      queue_size;
+        chunks_t      chunks;
+        placement_t   placement;
+        everification verification;
+        uint32_t      runs;
+        double        bytes_mean = 0.0, bytes_ci = 0.0;         // bytes/s, ci: half-width of the 95% confidence interval
+        double        messages_mean = 0.0, messages_ci = 0.0;   // messages/s
+        double        write_retries = 0.0, read_retries = 0.0;  // per message
+    };
+
+    auto parse(int _argc, const char* _argv[], options_t& _options) -> bool;
+    void usage();
+
+    template<everification VERIFICATION>
+    auto transmision(uint64_t _queue_size, const uint8_t* _source, const vector<uint64_t>& _sizes, uint64_t _bytes, placement_t _placement) -> run_t;
+    auto measure(const options_t& _options, const uint8_t* _source, uint64_t _queue_size, chunks_t _chunks, placement_t _placement, everification _verification) -> point_t;
+    auto confidence(const vector<double>& _samples, double& _mean) -> double;
+
+    auto chunks_name(chunks_t _chunks) -> string;
+    auto placement_name(placement_t _placement) -> string;
+    auto verification_name(everification _verification) -> const char*;
+    void print(const point_t& _point);
+    auto write_csv(const string& _path, const vector<point_t>& _points) -> bool;
+    auto write_json(const string& _path, const options_t& _options, const vector<point_t>& _points) -> bool;
+
+}
+
+// main procedure
+//
+// Sweeps queue size × chunk size distribution × core placement × verification mode over `tx_queue_sp_t<>`. Every
+// point is run `-r` times; each run sends `-b` bytes of random payload as `[size][payload]` transactions (as the `intra`
+// project does), the consumer inspects the payload in place. Throughput is reported in bytes/s and messages/s, as the
+// mean and the half-width of its 95% confidence interval (Student's t over the runs)
+//
+// usage: bench [-q 4K,16K,...] [-c 16,147-8K,...] [-p any,0:1,...] [-v none,checksum,sha256] [-r runs] [-b bytes]
+//              [-o results.csv|results.json]
+//
+// Chunk sizes are drawn from a fixed seed, so every run and every build sends the same sequence
+
+auto main(int _argc, const char* _argv[]) -> int {
+    auto options = options_t{};
+    if (!parse(_argc, _argv, options)) {
+        usage();
+        return -1;
+    }
+
+    // random payload
+
+    auto source = make_unique<uint8_t[]>(k_source_size);
+    auto gen    = mt19937_64(0x7e57);
+    for (auto i = uint64_t{0}; i < k_source_size; i += sizeof(uint64_t)) {
+        const auto value = gen();
+        memcpy(source.get() + i, &value, sizeof(value));
+    }
+
+    const auto total = options.queue_sizes.size() * options.chunks.size() * options.placements.size() * options.verifications.size();
+    cout << "== Points: " << total << ", runs: " << options.repeats << ", payload per run: " << format_size(options.bytes) << "\n\n";
+
+    auto points = vector<point_t>{};
+    for (const auto queue_size : options.queue_sizes) {
+        for (const auto chunks : options.chunks) {
+            if (chunks.max + sizeof(uint64_t) > queue_size) {
+                cout << "  queue " << setw(12) << format_size(queue_size) << " | chunks " << setw(12) << chunks_name(chunks) << " | skipped: the largest chunk does not fit\n";
+                continue;
+            }
+            for (const auto placement : options.placements) {
+                for (const auto verification : options.verifications) {
+                    const auto point = measure(options, source.get(), queue_size, chunks, placement, verification);
+                    if (point.runs == 0) {
+                        cout << "Error: transmission failed (queue " << format_size(queue_size) << ", chunks " << chunks_name(chunks) << ")\n";
+                        return -1;
+                    }
+                    print(point);
+                    points.push_back(point);
+                }
+            }
+        }
+    }
+
+    if (!options.output.empty()) {
+        const auto json = options.output.ends_with(".json");
+        if (!(json ? write_json(options.output, options, points) : write_csv(options.output, points))) {
+            cout << "Error: cannot write " << options.output << "\n";
+            return -1;
+        }
+        cout << "\n== Results written to " << options.output << "\n";
+    }
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto parse(int _argc, const char* _argv[], options_t& _options) -> bool {
+        // lists are comma separated, sizes take a K/M/G suffix
+
+        const auto split = [](string_view _list) {
+            auto result = vector<string>{};
+            while (!_list.empty()) {
+                const auto comma = _list.find(',');
+                result.emplace_back(_list.substr(0, comma));
+                _list = comma == string_view::npos ? string_view{} : _list.substr(comma + 1);
+            }
+            return result;
+        };
+        const auto size = [](const string& _text) {
+            auto end   = (char*)nullptr;
+            auto value = strtoull(_text.c_str(), &end, 10);
+            switch (*end) {
+                case 'K': value *= 1_KiB; break;
+                case 'M': value *= 1_MiB; break;
+                case 'G': value *= 1_GiB; break;
+            }
+            return value;
+        };
+
+        for (auto i = 1; i + 1 < _argc; i += 2) {
+            const auto arg   = string_view(_argv[i]);
+            const auto items = split(_argv[i + 1]);
+            if (arg == "-q") {
+                _options.queue_sizes.clear();
+                for (const auto& item : items) {
+                    _options.queue_sizes.push_back(size(item));
+                }
+            } else if (arg == "-c") {
+                _options.chunks.clear();
+                for (const auto& item : items) {
+                    const auto dash = item.find('-');
+                    const auto min  = size(item.substr(0, dash));
+                    const auto max  = dash == string::npos ? min : size(item.substr(dash + 1));
+                    if (min == 0 || max < min || max > k_source_size) {
+                        return false;
+                    }
+                    _options.chunks.push_back({min, max});
+                }
+            } else if (arg == "-p") {
+                _options.placements.clear();
+                for (const auto& item : items) {
+                    const auto colon = item.find(':');
+                    if (item == "any") {
+                        _options.placements.push_back({});
+                    } else if (colon != string::npos) {
+                        _options.placements.push_back({atoi(item.c_str()), atoi(item.c_str() + colon + 1)});
+                    } else {
+                        return false;
+                    }
+                }
+            } else if (arg == "-v") {
+                _options.verifications.clear();
+                for (const auto& item : items) {
+                    if (item == "none") {
+                        _options.verifications.push_back(NONE);
+                    } else if (item == "checksum") {
+                        _options.verifications.push_back(CHECKSUM);
+                    } else if (item == "sha256") {
+                        _options.verifications.push_back(SHA256);
+                    } else {
+                        return false;
+                    }
+                }
+            } else if (arg == "-r") {
+                _options.repeats = (uint32_t)max(atoi(_argv[i + 1]), 1);
+            } else if (arg == "-b") {
+                _options.bytes = max<uint64_t>(size(_argv[i + 1]), 1_MiB);
+            } else if (arg == "-o") {
+                _options.output = _argv[i + 1];
+            } else {
+                return false;
+            }
+        }
+        return (_argc % 2) == 1 && !_options.queue_sizes.empty() && !_options.chunks.empty() && !_options.placements.empty() && !_options.verifications.empty();
+    }
+
+    void usage() {
+        cout << "usage: bench [-q sizes] [-c chunks] [-p placements] [-v verifications] [-r runs] [-b bytes] [-o file]\n"
+                "  -q  queue sizes (default 4K,16K,64K,256K,1M)\n"
+                "  -c  chunk sizes, fixed (64) or uniform in a range (147-8K) (default 16,256,4K,147-8K)\n"
+                "  -p  core placements, any or producer:consumer (default any,0:1)\n"
+                "  -v  verifications: none, checksum, sha256 (default none)\n"
+                "  -r  runs per point (default 5)\n"
+                "  -b  payload per run (default 256M)\n"
+                "  -o  results file: .json for JSON, CSV otherwise\n";
+    }
+
+    template<everification VERIFICATION>
+    auto transmision(uint64_t _queue_size, const uint8_t* _source, const vector<uint64_t>& _sizes, uint64_t _bytes, placement_t _placement) -> run_t {
+        auto queue = make_unique<tx_queue_sp_t<>>(_queue_size);
+        if (!*queue) {
+            return {};
+        }
+
+        auto result         = run_t{};
+        auto ready          = atomic<int>{0};
+        auto producer_hash  = conditional_t<VERIFICATION == SHA256, sha256::status_t, checksum::status_t>{};
+        auto consumer_hash  = producer_hash;
+        auto consumer_bytes = uint64_t{0};
+        auto start_time     = steady_clock::time_point{};
+        auto end_time       = steady_clock::time_point{};
+
+        const auto start = [&]() {  // both threads placed before any of them starts
+            ready.fetch_add(1);
+            while (ready.load() < 3) {
+                _mm_pause();
+            }
+        };
+
+        auto consumer = thread([&]() {
+            start();
+            while (true) {
+                auto tx   = tx_read_t(*queue);
+                auto size = uint64_t{0};
+                tx.read(size);
+                auto chunk = tx.peek(size);  // in place, no copy
+                tx.skip(size);
+                if (!tx) {
+                    ++result.read_retries;
+                    continue;
+                }
+                if (size == 0) {
+                    break;
+                }
+                if constexpr (VERIFICATION != NONE) {
+                    update(consumer_hash, chunk.first.data(), chunk.first.size());
+                    update(consumer_hash, chunk.second.data(), chunk.second.size());
+                }
+                consumer_bytes += size;
+            }
+            end_time = steady_clock::now();
+        });
+
+        auto producer = thread([&]() {
+            start();
+            start_time  = steady_clock::now();
+            auto sent   = uint64_t{0};
+            auto offset = uint64_t{0};
+            while (sent < _bytes) {
+                const auto size = min(_sizes[result.messages % _sizes.size()], _bytes - sent);
+                if (offset + size > k_source_size) {
+                    offset = 0;
+                }
+
+                auto tx = tx_write_t(*queue);
+                tx.write(size);
+                tx.write(_source + offset, size);
+                if (!tx) {
+                    ++result.write_retries;
+                    continue;
+                }
+                if constexpr (VERIFICATION != NONE) {
+                    update(producer_hash, _source + offset, size);
+                }
+                sent   += size;
+                offset += size;
+                ++result.messages;
+            }
+
+            // end of the run
+
+            while (true) {
+                if (auto tx = tx_write_t(*queue); tx.write(uint64_t{0})) {
+                    break;
+                }
+            }
+        });
+
+        set_thread_affinity(producer, _placement.producer);
+        set_thread_affinity(consumer, _placement.consumer);
+        ready.fetch_add(1);
+        producer.join();
+        consumer.join();
+
+        if (consumer_bytes != _bytes || !(to_digest(producer_hash) == to_digest(consumer_hash))) {
+            return {};
+        }
+        result.ns = duration_cast<nanoseconds>(end_time - start_time).count();
+        return result;
+    }
+
+    auto measure(const options_t& _options, const uint8_t* _source, uint64_t _queue_size, chunks_t _chunks, placement_t _placement, everification _verification) -> point_t {
+        auto gen   = mt19937_64(_chunks.min * 31 + _chunks.max);
+        auto dist  = uniform_int_distribution<uint64_t>(_chunks.min, _chunks.max);
+        auto sizes = vector<uint64_t>(k_sizes_count);
+        for (auto& size : sizes) {
+            size = dist(gen);
+        }
+
+        auto bytes         = vector<double>{};
+        auto messages      = vector<double>{};
+        auto write_retries = 0.0;
+        auto read_retries  = 0.0;
+        for (auto i = 0u; i < _options.repeats; ++i) {
+            auto run = run_t{};
+            switch (_verification) {
+                case NONE: run = transmision<NONE>(_queue_size, _source, sizes, _options.bytes, _placement); break;
+                case CHECKSUM: run = transmision<CHECKSUM>(_queue_size, _source, sizes, _options.bytes, _placement); break;
+                case SHA256: run = transmision<SHA256>(_queue_size, _source, sizes, _options.bytes, _placement); break;
+            }
+            if (run.ns <= 0) {
+                return {_queue_size, _chunks, _placement, _verification, 0};
+            }
+            const auto seconds = (double)run.ns / 1e9;
+            bytes.push_back((double)_options.bytes / seconds);
+            messages.push_back((double)run.messages / seconds);
+            write_retries += (double)run.write_retries / (double)run.messages / _options.repeats;
+            read_retries  += (double)run.read_retries / (double)run.messages / _options.repeats;
+        }
+
+        auto result          = point_t{_queue_size, _chunks, _placement, _verification, _options.repeats};
+        result.bytes_ci      = confidence(bytes, result.bytes_mean);
+        result.messages_ci   = confidence(messages, result.messages_mean);
+        result.write_retries = write_retries;
+        result.read_retries  = read_retries;
+        return result;
+    }
+
+    auto confidence(const vector<double>& _samples, double& _mean) -> double {
+        // half-width of the 95% interval of the mean: t(n - 1) * s / sqrt(n) (0 with a single run)
+
+        static constexpr double t_95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                          2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                          2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+        const auto n = _samples.size();
+        _mean        = 0.0;
+        for (const auto sample : _samples) {
+            _mean += sample / (double)n;
+        }
+        if (n < 2) {
+            return 0.0;
+        }
+
+        auto variance = 0.0;
+        for (const auto sample : _samples) {
+            variance += (sample - _mean) * (sample - _mean) / (double)(n - 1);
+        }
+        const auto t = n - 1 <= size(t_95) ? t_95[n - 2] : 1.960;
+        return t * sqrt(variance / (double)n);
+    }
+
+    auto chunks_name(chunks_t _chunks) -> string {
+        return _chunks.min == _chunks.max ? to_string(_chunks.min) : to_string(_chunks.min) + "-" + to_string(_chunks.max);
+    }
+
+    auto placement_name(placement_t _placement) -> string {
+        return _placement.producer < 0 && _placement.consumer < 0 ? "any" : to_string(_placement.producer) + ":" + to_string(_placement.consumer);
+    }
+
+    auto verification_name(everification _verification) -> const char* {
+        switch (_verification) {
+            case CHECKSUM: return "checksum";
+            case SHA256: return "sha256";
+            default: return "none";
+        }
+    }
+
+    void print(const point_t& _point) {
+        const auto mib = [](double _bytes) { return _bytes / (double)1_MiB; };
+
+        cout << "  queue " << setw(12) << format_size(_point.queue_size) << " | chunks " << setw(12) << chunks_name(_point.chunks)               //
+             << " | cores " << setw(5) << placement_name(_point.placement) << " | " << setw(8) << verification_name(_point.verification)         //
+             << " | " << fixed << setprecision(2) << setw(10) << mib(_point.bytes_mean) << " ± " << setw(8) << mib(_point.bytes_ci) << " MiB/s"  //
+             << " | " << setprecision(3) << setw(8) << _point.messages_mean / 1e6 << " ± " << setw(6) << _point.messages_ci / 1e6 << " Mmsg/s"   //
+             << " | retries w " << setw(6) << _point.write_retries << " r " << setw(6) << _point.read_retries << " /msg\n";
+    }
+
+    auto write_csv(const string& _path, const vector<point_t>& _points) -> bool {
+        auto file = ofstream(_path, ios::trunc);
+        file << "queue_size,chunk_min,chunk_max,producer_core,consumer_core,verification,runs,"
+                "bytes_per_s,bytes_per_s_ci95,msgs_per_s,msgs_per_s_ci95,write_retries_per_msg,read_retries_per_msg\n";
+        file << fixed << setprecision(3);
+        for (const auto& point : _points) {
+            file << point.queue_size << "," << point.chunks.min << "," << point.chunks.max << ","                                //
+                 << point.placement.producer << "," << point.placement.consumer << "," << verification_name(point.verification)  //
+                 << "," << point.runs << "," << point.bytes_mean << "," << point.bytes_ci << "," << point.messages_mean << ","   //
+                 << point.messages_ci << "," << point.write_retries << "," << point.read_retries << "\n";
+        }
+        return (bool)file;
+    }
+
+    auto write_json(const string& _path, const options_t& _options, const vector<point_t>& _points) -> bool {
+        auto file = ofstream(_path, ios::trunc);
+        file << fixed << setprecision(3);
+        file << "{\n  \"runs\": " << _options.repeats << ",\n  \"bytes_per_run\": " << _options.bytes << ",\n  \"confidence\": 0.95,\n  \"points\": [";
+        for (auto i = size_t{0}; i < _points.size(); ++i) {
+            const auto& point = _points[i];
+            file << (i ? "," : "") << "\n    {"                                                                                                   //
+                 << "\"queue_size\": " << point.queue_size << ", \"chunk_min\": " << point.chunks.min << ", \"chunk_max\": " << point.chunks.max  //
+                 << ", \"producer_core\": " << point.placement.producer << ", \"consumer_core\": " << point.placement.consumer                    //
+                 << ", \"verification\": \"" << verification_name(point.verification) << "\", \"runs\": " << point.runs                           //
+                 << ", \"bytes_per_s\": " << point.bytes_mean << ", \"bytes_per_s_ci95\": " << point.bytes_ci                                     //
+                 << ", \"msgs_per_s\": " << point.messages_mean << ", \"msgs_per_s_ci95\": " << point.messages_ci                                 //
+                 << ", \"write_retries_per_msg\": " << point.write_retries << ", \"read_retries_per_msg\": " << point.read_retries << "}";
+        }
+        file << "\n  ]\n}\n";
+        return (bool)file;
+    }
+
+}  // namespace
@@ -0,0 +1,211 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages   = uint64_t{5'000'000};
+constexpr auto k_queue_size = (uint64_t)1_MiB;
+
+// local tests
+
+namespace {
+
+    template<uint32_t READERS>
+    auto broadcast() -> int64_t;
+
+    template<uint32_t READERS>
+    auto queue_per_reader() -> int64_t;
+
+    template<uint32_t READERS>
+    void report();
+
+    template<typename QTYPE>
+    auto unknown_reader(QTYPE& _queue) -> bool;
+
+}
+
+// main procedure
+//
+// One producer fans 32 byte records out to N reader threads, which check the order:
+// ● broadcast: one `tx_broadcast_sp_t`, the producer writes every record once
+// ● queue per reader: one `tx_queue_sp_t` per reader, the producer writes every record N times
+//
+// First, a reader out of range (`reader >= READERS`) must get nothing and touch nothing, on both versions
+
+auto main() -> int {
+    {
+        using mp_queue_t = tx_broadcast_mp_t<2>;
+        constexpr auto memory_size = sizeof(tx_broadcast_status_t<2>) + 4_KiB;
+
+        auto sp_queue = tx_broadcast_sp_t<2>(4_KiB);
+        auto memory   = make_unique<uint8_t[]>(memory_size + CACHE_LINE_SIZE);
+        auto mp_queue = mp_queue_t((uint8_t*)(((uintptr_t)memory.get() + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1)), memory_size);
+        if (!unknown_reader(sp_queue) || !unknown_reader(mp_queue)) {
+            cout << "Error: a reader out of range was not rejected\n";
+            return -1;
+        }
+    }
+
+    cout << "== Messages: " << k_messages << ", queue size: " << format_size(k_queue_size) << "\n\n";
+
+    report<1>();
+    report<2>();
+    report<3>();
+    report<4>();
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    template<uint32_t READERS>
+    auto broadcast() -> int64_t {
+        auto queue = tx_broadcast_sp_t<READERS>(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto errors     = vector<uint64_t>(READERS, 0);
+        auto readers    = vector<thread>{};
+        auto start_time = high_resolution_clock::now();
+        for (auto r = 0u; r < READERS; ++r) {
+            readers.emplace_back([&queue, &errors, r]() {
+                for (auto i = uint64_t{0}; i < k_messages;) {
+                    auto tx           = tx_read_t(queue, r);
+                    auto [a, b, c, d] = tx.template read<uint64_t, uint64_t, uint64_t, uint64_t>();
+                    if (tx) {
+                        errors[r] += a != i || b != i * 3 || c != i * 5 || d != i * 7;
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (auto tx = tx_write_t(queue); tx.write(i, i * 3, i * 5, i * 7)) {
+                ++i;
+            }
+        }
+
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        for (auto e : errors) {
+            if (e) {
+                return -1;
+            }
+        }
+        return duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    template<uint32_t READERS>
+    auto queue_per_reader() -> int64_t {
+        auto queues = vector<unique_ptr<tx_queue_sp_t<>>>{};
+        for (auto r = 0u; r < READERS; ++r) {
+            queues.push_back(make_unique<tx_queue_sp_t<>>(k_queue_size));
+            if (!*queues.back()) {
+                return -1;
+            }
+        }
+
+        auto errors     = vector<uint64_t>(READERS, 0);
+        auto readers    = vector<thread>{};
+        auto start_time = high_resolution_clock::now();
+        for (auto r = 0u; r < READERS; ++r) {
+            readers.emplace_back([&queue = *queues[r], &errors, r]() {
+                for (auto i = uint64_t{0}; i < k_messages;) {
+                    auto tx           = tx_read_t(queue);
+                    auto [a, b, c, d] = tx.template read<uint64_t, uint64_t, uint64_t, uint64_t>();
+                    if (tx) {
+                        errors[r] += a != i || b != i * 3 || c != i * 5 || d != i * 7;
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        for (auto i = uint64_t{0}; i < k_messages; ++i) {
+            for (auto& queue : queues) {
+                while (true) {
+                    if (auto tx = tx_write_t(*queue); tx.write(i, i * 3, i * 5, i * 7)) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        for (auto e : errors) {
+            if (e) {
+                return -1;
+            }
+        }
+        return duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    template<uint32_t READERS>
+    void report() {
+        const auto broadcast_ns = broadcast<READERS>();
+        const auto queues_ns    = queue_per_reader<READERS>();
+        if (broadcast_ns < 0 || queues_ns < 0) {
+            cout << "Error: transmission failed with " << READERS << " readers\n";
+            return;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  readers " << setw(2) << READERS                                                         //
+             << " | broadcast " << fixed << setprecision(2) << setw(8) << rate(broadcast_ns) << " Mmsg/s"  //
+             << " | queue per reader " << setw(8) << rate(queues_ns) << " Mmsg/s"                          //
+             << " | speedup x" << (double)queues_ns / (double)broadcast_ns << "\n";
+    }
+
+    template<typename QTYPE>
+    auto unknown_reader(QTYPE& _queue) -> bool {
+        if (!_queue) {
+            return false;
+        }
+        if (auto tx = tx_write_t(_queue); !tx.write(uint64_t{42})) {
+            return false;
+        }
+
+        // rejected, then the known readers still get the message
+
+        auto value = uint64_t{0};
+        if (auto tx = tx_read_t(_queue, QTYPE::readers); tx || tx.read(value) || read_wait(_queue, QTYPE::readers, sizeof(value), steady_clock::now())) {
+            return false;
+        }
+        for (auto r = 0u; r < QTYPE::readers; ++r) {
+            if (auto tx = tx_read_t(_queue, r); !tx.read(value) || value != 42) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace
@@ -5,22 +5,36 @@
 // C++
 
 #include <cstdint>
+#include <cctype>
 #include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 #include <string>
 #include <random>
 #include <thread>
 
-// Windows
+// windows
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
+#if _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <Windows.h>
+#endif
 
-// Help literal operators
+// linux
 
-inline constexpr auto operator""_KiB(uint64_t _amount) -> uint64_t { return 1024u * _amount; }
-inline constexpr auto operator""_MiB(uint64_t _amount) -> uint64_t { return 1024u * 1024u * _amount; }
-inline constexpr auto operator""_GiB(uint64_t _amount) -> uint64_t { return 1024u * 1024u * 1024u * _amount; }
+#if !_WIN32
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+// Help literal operators (the standard signature takes `unsigned long long`, which is not `uint64_t` everywhere)
+
+inline constexpr auto operator""_KiB(unsigned long long _amount) -> uint64_t { return 1024u * _amount; }
+inline constexpr auto operator""_MiB(unsigned long long _amount) -> uint64_t { return 1024u * 1024u * _amount; }
+inline constexpr auto operator""_GiB(unsigned long long _amount) -> uint64_t { return 1024u * 1024u * 1024u * _amount; }
 
 template<typename Clock, typename Duration = typename Clock::duration>
 auto get_timestamp_str(std::chrono::time_point<Clock, Duration> _now) -> std::string {
@@ -29,7 +43,11 @@ auto get_timestamp_str(std::chrono::time_point<Clock, Duration> _now) -> std::st
     // Convert to time_t for local time information
     auto    time_now = Clock::to_time_t(_now);
     std::tm timeinfo;
+#if _WIN32
     localtime_s(&timeinfo, &time_now);
+#else
+    localtime_r(&time_now, &timeinfo);
+#endif
 
     // Calculate the precise time components
     auto duration_since_epoch = _now.time_since_epoch();
@@ -54,6 +72,7 @@ auto get_timestamp_str(std::chrono::time_point<Clock, Duration> _now) -> std::st
 
 void wait_until_key_release(int _key) {
     using namespace std;
+#if _WIN32
     while (!(GetAsyncKeyState(_key) & 0x8000)) {
         this_thread::sleep_for(10ms);
     }
@@ -61,6 +80,15 @@ void wait_until_key_release(int _key) {
     while (GetAsyncKeyState(_key) & 0x8000) {
         this_thread::sleep_for(10ms);
     }
+#else
+    // no global key state on a terminal: the key has to be typed and followed by Enter
+
+    for (auto line = string{}; getline(cin, line);) {
+        if (!line.empty() && toupper((unsigned char)line[0]) == toupper(_key)) {
+            return;
+        }
+    }
+#endif
 }
 
 template<typename T>
@@ -82,16 +110,31 @@ auto set_thread_affinity(std::thread& _thread, int _core) -> bool {
         return false;
     }
 
+#if _WIN32
     auto mask = (DWORD_PTR)(1ULL << _core);
     if (!SetThreadAffinityMask(thread_handle, mask)) {
         return false;
     }
+#else
+    auto mask = cpu_set_t{};
+    CPU_ZERO(&mask);
+    CPU_SET(_core, &mask);
+    if (pthread_setaffinity_np(thread_handle, sizeof(mask), &mask) != 0) {
+        return false;
+    }
+#endif
     return true;
 }
 
+#if _WIN32
 inline __declspec(noinline) auto get_current_thread_core() -> int {
     return (int)GetCurrentProcessorNumber();
 }
+#else
+inline __attribute__((noinline)) auto get_current_thread_core() -> int {
+    return sched_getcpu();
+}
+#endif
 
 auto format_throughput(uint64_t _bytes, int64_t _ns) -> std::string {
     using namespace std;
@@ -4,8 +4,10 @@
 #include <new>
 #include <array>
 
-#pragma warning(push)
-#pragma warning(disable : 4324)  // remove padding warning
+#if _WIN32
+#    pragma warning(push)
+#    pragma warning(disable : 4324)  // remove padding warning
+#endif
 
 namespace qcstudio::sha256 {
 
@@ -27,7 +29,7 @@ namespace qcstudio::sha256 {
         auto     operator==(const digest_t& _other) const -> bool;
     };
 
-    struct alignas(hardware_destructive_interference_size) status_t {
+    struct alignas(64) status_t {
         uint8_t  curr_block[64];
         uint64_t total_num_bits = 0;
         uint32_t h[8]           = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
@@ -75,7 +77,7 @@ inline void qcstudio::sha256::update(status_t& _status, const uint8_t* _buffer,
     auto eob = _buffer + _size;
     while (pc < eob) {
         const auto available     = 64ull - _status.cur;
-        const auto bytes_to_copy = min(available, (uint64_t)(eob - pc));
+        const auto bytes_to_copy = min<uint64_t>(available, (uint64_t)(eob - pc));
         memcpy(&_status.curr_block[_status.cur], pc, (size_t)bytes_to_copy);
         _status.cur += bytes_to_copy;
         _status.total_num_bits += bytes_to_copy * 8;
@@ -208,4 +210,6 @@ namespace {
 
 }  // namespace
 
-#pragma warning(pop)
+#if _WIN32
+#    pragma warning(pop)
+#endif
@@ -8,11 +8,27 @@
 #include <utility>
 #include <string>
 
-// Windows
+// windows
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
+#if _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <Windows.h>
+#endif
+
+// linux
+
+#if !_WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/socket.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+// qcstudio
+
+#include "tx-queue.h"
 
 namespace qcstudio {
 
@@ -23,30 +39,71 @@ namespace qcstudio {
         ● Specify buffer size to be the producer, others are consumers
         ● Naturally cache-line-aligned
         ● Contains cache-line header with buffer size
+        ● Optionally, the last `_mirrored_size` bytes of the buffer are mapped twice, back to back
+          (must be multiple of the allocation granularity; see `tx_storage_t::MIRRORED`)
+        ● Optionally, backed by large pages (falls back to regular pages, see `is_huge`; not with a mirrored tail)
+          (see `tx_storage_t::HUGE_PAGES`)
+        ● Optionally, prefaulted on mapping and locked in RAM (see `is_locked`), so that no page fault hits the
+          first transactions of a session
+        ● Optionally, opened read-only (monitors such as `txq-top`, they cannot disturb the processes)
+
+        Linux:
+        ● Named segments are POSIX shared memory (`shm_open`, `/dev/shm`), large pages ones are files on the
+          hugetlbfs mount (`/dev/hugepages`); the creator unlinks them on destruction
+        ● Unnamed segments (`nullptr` name) are a memfd, only reachable through `send` over a unix socket
+        ● Prefaulting is `MAP_POPULATE`, locking is `mlock` (bounded by `RLIMIT_MEMLOCK`)
     */
 
     class shared_memory {
     public:
         shared_memory() = delete;
-        shared_memory(const wchar_t* _name, uint64_t _size = 0);  // If no size is specified, it is an `open` operation
+        shared_memory(const wchar_t* _name, uint64_t _size = 0, uint64_t _mirrored_size = 0, bool _huge_pages = false, bool _prefault = false, bool _lock = false, bool _read_only = false);  // If no size is specified, it is an `open` operation (`_read_only` only applies there)
         ~shared_memory();
 
         void* operator*();
         auto  get_size() const -> uint64_t;
+        auto  is_mirrored() const -> bool;
+        auto  is_huge() const -> bool;
+        auto  is_locked() const -> bool;
+
+#if !_WIN32
+        shared_memory(int _socket, bool _prefault = false, bool _lock = false);  // open the segment received from a unix socket
+        auto send(int _socket) const -> bool;                                    // pass the segment to the process on the other end
+#endif
 
     private:
         void create_buffer();
         void open_buffer();
+        void map_views();
+        auto get_buffer_offset() const -> uint64_t;
+        auto get_mapping_size() const -> uint64_t;
+        void prefault_and_lock();
+#if !_WIN32
+        auto get_posix_name() const -> string;
+#endif
         void lock();
         void unlock();
 
         friend class shared_memory_lock_guard;
 
-        const wchar_t* name_       = nullptr;
-        char*          map_buffer_ = nullptr;
-        HANDLE         map_file_   = INVALID_HANDLE_VALUE;
-        uint64_t       size_       = 0;
-        bool           create_     = true;
+        const wchar_t* name_          = nullptr;
+        char*          map_buffer_    = nullptr;
+        char*          map_view_      = nullptr;
+        char*          mirror_view_   = nullptr;
+#if _WIN32
+        HANDLE map_file_ = INVALID_HANDLE_VALUE;
+#else
+        int    map_file_ = -1;
+        string path_;  // under /dev/shm or /dev/hugepages, to unlink it
+#endif
+        uint64_t size_          = 0;
+        uint64_t mirrored_size_ = 0;
+        bool     create_        = true;
+        bool     huge_pages_    = false;
+        bool     prefault_      = false;
+        bool     lock_          = false;
+        bool     locked_        = false;
+        bool     read_only_     = false;
     };
 
 }  // namespace qcstudio
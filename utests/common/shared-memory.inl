@@ -1,5 +1,9 @@
 // Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
 
+#if _WIN32
+#    pragma comment(lib, "onecore.lib")  // VirtualAlloc2 / MapViewOfFile3
+#endif
+
 namespace qcstudio {
 
     using namespace std;
@@ -8,8 +12,20 @@ namespace qcstudio {
         return size_;
     }
 
-    inline shared_memory::shared_memory(const wchar_t* _name, uint64_t _size)
-        : name_(_name), map_buffer_(nullptr), map_file_(INVALID_HANDLE_VALUE), size_(_size), create_(_size != 0) {
+    inline auto shared_memory::is_mirrored() const -> bool {
+        return mirrored_size_ != 0;
+    }
+
+    inline auto shared_memory::is_huge() const -> bool {
+        return huge_pages_;
+    }
+
+    inline auto shared_memory::is_locked() const -> bool {
+        return locked_;
+    }
+
+    inline shared_memory::shared_memory(const wchar_t* _name, uint64_t _size, uint64_t _mirrored_size, bool _huge_pages, bool _prefault, bool _lock, bool _read_only)
+        : name_(_name), map_buffer_(nullptr), size_(_size), mirrored_size_(_mirrored_size), create_(_size != 0), huge_pages_(_huge_pages && !_mirrored_size), prefault_(_prefault), lock_(_lock), read_only_(_read_only && _size == 0) {
         if (create_) {
             create_buffer();
         } else {
@@ -17,13 +33,81 @@ namespace qcstudio {
         }
     }
 
+#if !_WIN32
+    inline shared_memory::shared_memory(int _socket, bool _prefault, bool _lock) : create_(false), prefault_(_prefault), lock_(_lock) {
+        // the descriptor travels as ancillary data of a one-byte message
+
+        auto payload = char{0};
+        auto io      = iovec{&payload, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+        auto message           = msghdr{};
+        message.msg_iov        = &io;
+        message.msg_iovlen     = 1;
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+        if (recvmsg(_socket, &message, MSG_CMSG_CLOEXEC) != 1) {
+            return;
+        }
+
+        auto header = CMSG_FIRSTHDR(&message);
+        if (!header || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+            return;
+        }
+        memcpy(&map_file_, CMSG_DATA(header), sizeof(int));
+        open_buffer();
+    }
+
+    inline auto shared_memory::send(int _socket) const -> bool {
+        if (map_file_ == -1) {
+            return false;
+        }
+
+        auto payload = char{0};
+        auto io      = iovec{&payload, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+        auto message           = msghdr{};
+        message.msg_iov        = &io;
+        message.msg_iovlen     = 1;
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+
+        auto header        = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type  = SCM_RIGHTS;
+        header->cmsg_len   = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(header), &map_file_, sizeof(int));
+        return sendmsg(_socket, &message, MSG_NOSIGNAL) == 1;
+    }
+#endif
+
     inline shared_memory::~shared_memory() {
-        if (map_buffer_) {
-            UnmapViewOfFile(map_buffer_);
+#if _WIN32
+        if (map_view_) {
+            UnmapViewOfFile(map_view_);
+        }
+        if (mirror_view_) {
+            UnmapViewOfFile(mirror_view_);
         }
         if (map_file_ != INVALID_HANDLE_VALUE) {
             CloseHandle(map_file_);
         }
+#else
+        if (map_view_) {
+            munmap(map_view_, mirrored_size_ ? get_buffer_offset() + size_ + mirrored_size_ : get_mapping_size());  // both views are one range
+        }
+        if (map_file_ != -1) {
+            close(map_file_);
+        }
+        if (create_ && !path_.empty()) {
+            if (huge_pages_) {
+                unlink(path_.c_str());
+            } else {
+                shm_unlink(path_.c_str());
+            }
+        }
+#endif
     }
 
     inline void* shared_memory::operator*() {
@@ -38,6 +122,11 @@ namespace qcstudio {
     }
 
     inline void shared_memory::create_buffer() {
+        if (mirrored_size_ > size_) {
+            return;
+        }
+
+#if _WIN32
         const auto split_size = [](uint64_t _size) -> pair<DWORD, DWORD> {
             auto highOrder = static_cast<DWORD>((_size >> 32) & 0xFFffFFff);
             auto lowOrder  = static_cast<DWORD>(_size & 0xFFffFFff);
@@ -51,31 +140,270 @@ namespace qcstudio {
         sa.nLength              = sizeof(SECURITY_ATTRIBUTES);
         sa.lpSecurityDescriptor = &sd;
         sa.bInheritHandle       = FALSE;
-        auto total_size         = size_ + std::hardware_destructive_interference_size;
-        auto [hi, lo]           = split_size(total_size);
 
-        map_file_ = CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE, hi, lo, name_);
+        // large pages first (committed upon creation, the size is rounded up to the large page size)
+
+        if (huge_pages_) {
+            auto [hi, lo] = split_size(get_mapping_size());
+            map_file_     = vmem::enable_huge_pages() ? CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES, hi, lo, name_) : nullptr;
+            huge_pages_   = map_file_ != nullptr;
+        }
+        if (!huge_pages_) {
+            auto [hi, lo] = split_size(get_mapping_size());
+            map_file_     = CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE, hi, lo, name_);
+        }
         if (map_file_) {
-            map_buffer_ = (char*)MapViewOfFile(map_file_, FILE_MAP_ALL_ACCESS, 0, 0, total_size);
+            map_views();
+        }
+#else
+        // large pages first: a file on the hugetlbfs mount, or a memfd (the pages are reserved upon mapping, so it
+        // fails there if the pool is short)
+
+        const auto name = get_posix_name();
+        if (huge_pages_) {
+            if (name_) {
+                path_     = "/dev/hugepages" + name;
+                map_file_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+            } else {
+                map_file_ = memfd_create("shared-memory", MFD_CLOEXEC | MFD_HUGETLB);
+            }
+            if (map_file_ != -1 && ftruncate(map_file_, (off_t)get_mapping_size()) == 0) {
+                map_views();
+            }
+            if (!map_buffer_) {
+                if (map_file_ != -1) {
+                    close(map_file_);
+                    map_file_ = -1;
+                }
+                if (!path_.empty()) {
+                    unlink(path_.c_str());
+                    path_.clear();
+                }
+                huge_pages_ = false;
+            }
+        }
+        if (!huge_pages_) {
+            if (name_) {
+                path_     = name;
+                map_file_ = shm_open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+            } else {
+                map_file_ = memfd_create("shared-memory", MFD_CLOEXEC);
+            }
+            if (map_file_ != -1 && ftruncate(map_file_, (off_t)get_mapping_size()) == 0) {
+                map_views();
+            }
         }
+#endif
 
         if (map_buffer_) {
-            *((decltype(size_)*)map_buffer_) = size_;
-            map_buffer_ += std::hardware_destructive_interference_size;
+            auto header = (uint64_t*)map_view_;
+            header[0]   = size_;
+            header[1]   = mirrored_size_;
+            header[2]   = huge_pages_;
         }
     }
 
     inline void shared_memory::open_buffer() {
-        map_file_ = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name_);
+#if _WIN32
+        const auto access = read_only_ ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS;
+        map_file_         = OpenFileMappingW(access, FALSE, name_);
         if (!map_file_) {
             return;
         }
 
-        map_buffer_ = (char*)MapViewOfFile(map_file_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
-        if (map_buffer_) {
-            size_ = *(decltype(size_)*)map_buffer_;
-            map_buffer_ += std::hardware_destructive_interference_size;
+        // peek at the header to know the layout (views of large page sections may have to be large pages too)
+
+        auto header = (uint64_t*)MapViewOfFile(map_file_, access, 0, 0, CACHE_LINE_SIZE);
+        if (!header) {
+            header = (uint64_t*)MapViewOfFile(map_file_, access | FILE_MAP_LARGE_PAGES, 0, 0, vmem::huge_page_size());
+        }
+        if (!header) {
+            return;
+        }
+        size_          = header[0];
+        mirrored_size_ = header[1];
+        huge_pages_    = header[2] != 0;
+        UnmapViewOfFile(header);
+#else
+        // by name (regular pages first) unless it came through a socket
+
+        if (map_file_ == -1) {
+            if (!name_) {
+                return;
+            }
+            const auto name  = get_posix_name();
+            const auto flags = (read_only_ ? O_RDONLY : O_RDWR) | O_CLOEXEC;
+            map_file_        = shm_open(name.c_str(), flags, 0);
+            if (map_file_ == -1) {
+                map_file_ = open(("/dev/hugepages" + name).c_str(), flags);
+            }
+            if (map_file_ == -1) {
+                return;
+            }
+        }
+
+        // peek at the header to know the layout (the whole file, as large pages cannot be mapped partially; the
+        // creator may not have sized it or written the header yet)
+
+        struct stat file = {};
+        if (fstat(map_file_, &file) != 0 || file.st_size < (off_t)CACHE_LINE_SIZE) {
+            return;
+        }
+        auto header = (uint64_t*)mmap(nullptr, (size_t)file.st_size, PROT_READ, MAP_SHARED, map_file_, 0);
+        if (header == MAP_FAILED) {
+            return;
+        }
+        size_          = header[0];
+        mirrored_size_ = header[1];
+        huge_pages_    = header[2] != 0;
+        munmap(header, (size_t)file.st_size);
+        if (!size_) {
+            return;
+        }
+#endif
+
+        map_views();
+    }
+
+    inline void shared_memory::map_views() {
+        const auto offset = get_buffer_offset();
+
+#if _WIN32
+        const auto protection = read_only_ ? PAGE_READONLY : PAGE_READWRITE;
+
+        // plain: one view with the header and the buffer
+
+        if (!mirrored_size_) {
+            map_view_ = (char*)MapViewOfFile(map_file_, (read_only_ ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS) | (huge_pages_ ? FILE_MAP_LARGE_PAGES : 0), 0, 0, get_mapping_size());
+            if (map_view_) {
+                map_buffer_ = map_view_ + offset;
+                prefault_and_lock();
+            }
+            return;
+        }
+
+        // mirrored: the first view covers the header and the whole buffer, the second one repeats its mirrored tail
+
+        const auto first_size = offset + size_;
+        auto       base       = (char*)VirtualAlloc2(nullptr, nullptr, first_size + mirrored_size_, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, nullptr, 0);
+        if (!base) {
+            return;
+        }
+        VirtualFree(base, first_size, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER);
+
+        map_view_    = (char*)MapViewOfFile3(map_file_, nullptr, base, 0, first_size, MEM_REPLACE_PLACEHOLDER, protection, nullptr, 0);
+        mirror_view_ = (char*)MapViewOfFile3(map_file_, nullptr, base + first_size, first_size - mirrored_size_, mirrored_size_, MEM_REPLACE_PLACEHOLDER, protection, nullptr, 0);
+        if (!map_view_) {
+            VirtualFree(base, 0, MEM_RELEASE);
+        }
+        if (!mirror_view_) {
+            VirtualFree(base + first_size, 0, MEM_RELEASE);
+        }
+        if (map_view_ && mirror_view_) {
+            map_buffer_ = map_view_ + offset;
+            prefault_and_lock();
+        }
+#else
+        const auto flags      = MAP_SHARED | (prefault_ ? MAP_POPULATE : 0);
+        const auto protection = PROT_READ | (read_only_ ? 0 : PROT_WRITE);
+
+        // plain: one view with the header and the buffer
+
+        if (!mirrored_size_) {
+            auto view = (char*)mmap(nullptr, get_mapping_size(), protection, flags, map_file_, 0);
+            if (view != MAP_FAILED) {
+                map_view_   = view;
+                map_buffer_ = map_view_ + offset;
+                prefault_and_lock();
+            }
+            return;
+        }
+
+        // mirrored: reserve the range, then the first view covers the header and the whole buffer, the second one
+        // repeats its mirrored tail
+
+        const auto first_size = offset + size_;
+        auto       base       = (char*)mmap(nullptr, first_size + mirrored_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return;
+        }
+        if (mmap(base, first_size, protection, flags | MAP_FIXED, map_file_, 0) == MAP_FAILED ||
+            mmap(base + first_size, mirrored_size_, protection, flags | MAP_FIXED, map_file_, (off_t)(first_size - mirrored_size_)) == MAP_FAILED) {
+            munmap(base, first_size + mirrored_size_);
+            return;
+        }
+        map_view_    = base;
+        mirror_view_ = base + first_size;
+        map_buffer_  = map_view_ + offset;
+        prefault_and_lock();
+#endif
+    }
+
+    inline void shared_memory::prefault_and_lock() {
+        // the mirrored tail shares the pages of the first view, hence only the latter is touched/locked
+
+        const auto size = mirrored_size_ ? get_buffer_offset() + size_ : get_mapping_size();
+
+#if _WIN32
+        if (prefault_) {
+            for (auto page = uint64_t{0}; page < size; page += 4096) {
+                (void)*(volatile char*)(map_view_ + page);  // a read is enough to map the page (and safe on a live queue)
+            }
+        }
+        if (lock_) {
+            // large pages cannot be paged out, regular ones need room in the working set
+
+            locked_ = huge_pages_ || VirtualLock(map_view_, size);
+            if (!locked_) {
+                auto minimum = SIZE_T{}, maximum = SIZE_T{};
+                if (GetProcessWorkingSetSize(GetCurrentProcess(), &minimum, &maximum) && SetProcessWorkingSetSize(GetCurrentProcess(), minimum + size, maximum + size)) {
+                    locked_ = VirtualLock(map_view_, size);
+                }
+            }
+        }
+#else
+        if (lock_) {
+            locked_ = mlock(map_view_, size) == 0;  // it also faults in the pages `MAP_POPULATE` did not
+        }
+#endif
+    }
+
+    inline auto shared_memory::get_buffer_offset() const -> uint64_t {
+        // plain: the header takes one cache line
+
+        if (!mirrored_size_) {
+            return CACHE_LINE_SIZE;
+        }
+
+        // mirrored: pad so that the mirrored tail starts on an allocation granularity boundary
+
+        const auto granularity   = vmem::allocation_granularity();
+        const auto unmirrored    = CACHE_LINE_SIZE + size_ - mirrored_size_;
+        const auto mirror_offset = (unmirrored + granularity - 1) & ~(granularity - 1);
+        return mirror_offset - (size_ - mirrored_size_);
+    }
+
+    inline auto shared_memory::get_mapping_size() const -> uint64_t {
+        // header and buffer (large pages are mapped whole)
+
+        const auto size = get_buffer_offset() + size_;
+        if (!huge_pages_) {
+            return size;
+        }
+        const auto huge_page_size = vmem::huge_page_size();
+        return (size + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+#if !_WIN32
+    inline auto shared_memory::get_posix_name() const -> string {
+        // "/name", the ids are ascii
+
+        auto result = string("/");
+        for (auto c = name_; c && *c; ++c) {
+            result += *c > L' ' && *c < 0x7F && *c != L'/' ? (char)*c : '_';
         }
+        return result;
     }
+#endif
 
 }  // namespace qcstudio
@@ -18,8 +18,10 @@
 
 // warnings
 
-#pragma warning(push)
-#pragma warning(disable : 4324 4625 4626 5026 5027 4702)
+#if _WIN32
+#    pragma warning(push)
+#    pragma warning(disable : 4324 4625 4626 5026 5027 4702)
+#endif
 
 namespace qcstudio {
     using namespace std;
@@ -113,14 +115,8 @@ namespace qcstudio {
     public:
         utest_job_receive_buffer(QUEUE_TYPE& _queue);
 
-        // setters
-
-        void set_max_chunk_size(uint64_t _max_chunk_size);
-
     private:
         virtual void run();
-
-        uint64_t max_chunk_size_;
     };
 
     /*
@@ -157,4 +153,6 @@ namespace qcstudio {
 
 #include "utest_jobs.inl"
 
-#pragma warning(pop)
+#if _WIN32
+#    pragma warning(pop)
+#endif
@@ -146,18 +146,13 @@ void qcstudio::utest_job_transmit_buffer<QUEUE_TYPE, VERIFICATION>::run() {
     ================
     "receive buffer"
     ================
-    A buffer is received in chunks. Optionally a buffer hash is performed
+    A buffer is received in chunks, inspected in place (no copy). Optionally a buffer hash is performed
 */
 
 template<typename QUEUE_TYPE, qcstudio::everification VERIFICATION>
 qcstudio::utest_job_receive_buffer<QUEUE_TYPE, VERIFICATION>::utest_job_receive_buffer(QUEUE_TYPE& _queue) : qcstudio::utest_job<QUEUE_TYPE, VERIFICATION>(_queue) {
 }
 
-template<typename QUEUE_TYPE, qcstudio::everification VERIFICATION>
-void qcstudio::utest_job_receive_buffer<QUEUE_TYPE, VERIFICATION>::set_max_chunk_size(uint64_t _max_chunk_size) {
-    max_chunk_size_ = _max_chunk_size;
-}
-
 template<typename QUEUE_TYPE, qcstudio::everification VERIFICATION>
 void qcstudio::utest_job_receive_buffer<QUEUE_TYPE, VERIFICATION>::run() {
     using namespace std;
@@ -172,14 +167,14 @@ void qcstudio::utest_job_receive_buffer<QUEUE_TYPE, VERIFICATION>::run() {
 
     // recv
 
-    auto buffer       = make_unique<uint8_t[]>(max_chunk_size_);
     auto start_time   = high_resolution_clock::now();
     this->total_data_ = 0u;
     while (true) {
         if (auto read_op = tx_read_t(this->queue_)) {
             auto chunk_size = uint64_t{};
             read_op.read(chunk_size);
-            read_op.read(buffer.get(), chunk_size);
+            auto chunk = read_op.peek(chunk_size);  // in place, no copy
+            read_op.skip(chunk_size);
             if (!read_op) {
                 this->transaction_attempts_++;
                 continue;
@@ -190,9 +185,11 @@ void qcstudio::utest_job_receive_buffer<QUEUE_TYPE, VERIFICATION>::run() {
             }
 
             if constexpr (VERIFICATION == CHECKSUM) {
-                update(this->checksum_hash_status_, buffer.get(), chunk_size);
+                update(this->checksum_hash_status_, chunk.first.data(), chunk.first.size());
+                update(this->checksum_hash_status_, chunk.second.data(), chunk.second.size());
             } else if constexpr (VERIFICATION == SHA256) {
-                update(this->sha256_hash_status_, buffer.get(), chunk_size);
+                update(this->sha256_hash_status_, chunk.first.data(), chunk.first.size());
+                update(this->sha256_hash_status_, chunk.second.data(), chunk.second.size());
             }
 
             this->total_data_ += chunk_size;
@@ -223,7 +220,6 @@ void qcstudio::utest_job_interactive_transmitter<QUEUE_TYPE, VERIFICATION>::run(
     while (true) {
         wait_until_key_release('S');
         auto number    = get_random<uint16_t>();
-        auto now       = high_resolution_clock::now();
         auto ok        = false;
         auto timestamp = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
         if (auto tx = tx_write_t(this->queue_)) {
@@ -258,7 +254,7 @@ void qcstudio::utest_job_interactive_receiver<QUEUE_TYPE, VERIFICATION>::run() {
     using namespace chrono;
     while (true) {
         if (auto tx = tx_read_t(this->queue_)) {
-            if (auto [number, timestamp] = tx.read<uint16_t, int64_t>(); tx) {
+            if (auto [number, timestamp] = tx.template read<uint16_t, int64_t>(); tx) {
                 auto now_ns = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
                 cout << get_timestamp_str(system_clock::now()) << "|"                  //
                      << get_current_thread_core() << " [consumer] Just received \"0x"  //
@@ -0,0 +1,119 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-copy.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_bytes_per_point = (uint64_t)1_GiB;  // bytes copied per size and kernel
+constexpr auto k_buffer_size     = (uint64_t)64_MiB;
+
+// global data
+
+volatile uint8_t g_sink;  // keeps the copies alive
+
+// local tests
+
+namespace {
+
+    template<typename COPY>
+    auto measure(uint8_t* _dst, const uint8_t* _src, uint64_t _size, COPY&& _copy) -> int64_t;
+
+    template<uint64_t SIZE>
+    void measure_constant(uint8_t* _dst, const uint8_t* _src);
+
+}
+
+// main procedure
+//
+// Sweep the copy size and compare `memops::copy` (size class dispatch) against plain `memcpy`.
+// Source and destination move along the buffers, so big sizes do not stay in the caches
+//
+// Then the same for small sizes known at compile time, as `write(T)`/`read(T)` copy them: both sides should be a
+// couple of inlined moves, a call on the `memops::copy` side shows up here
+
+auto main() -> int {
+    auto src = make_unique<uint8_t[]>(k_buffer_size);
+    auto dst = make_unique<uint8_t[]>(k_buffer_size);
+    memset(src.get(), 0x5A, k_buffer_size);
+    memset(dst.get(), 0xA5, k_buffer_size);
+
+    cout << "== AVX2: " << (memops::has_avx2() ? "yes" : "no") << "\n\n";
+    cout << setw(10) << "bytes" << " | " << setw(14) << "memcpy" << " | " << setw(14) << "memops::copy" << " | speedup\n";
+
+    for (auto size = uint64_t{8}; size <= 16_MiB; size *= 2) {
+        for (auto actual_size : {size - 1, size}) {  // odd sizes exercise the overlapping tails
+            auto memcpy_ns = measure(dst.get(), src.get(), actual_size, [](uint8_t* _dst, const uint8_t* _src, uint64_t _size) { memcpy(_dst, _src, _size); });
+            auto memops_ns = measure(dst.get(), src.get(), actual_size, [](uint8_t* _dst, const uint8_t* _src, uint64_t _size) { memops::copy(_dst, _src, _size); });
+
+            auto total = k_bytes_per_point / actual_size * actual_size;
+            cout << setw(10) << actual_size                                 //
+                 << " | " << setw(14) << format_throughput(total, memcpy_ns)  //
+                 << " | " << setw(14) << format_throughput(total, memops_ns)  //
+                 << " | x" << fixed << setprecision(2) << (double)memcpy_ns / (double)memops_ns << "\n";
+        }
+    }
+    cout << endl;
+
+    cout << setw(10) << "constant" << " | " << setw(14) << "memcpy" << " | " << setw(14) << "memops::copy" << " | speedup\n";
+    measure_constant<4>(dst.get(), src.get());
+    measure_constant<8>(dst.get(), src.get());
+    measure_constant<12>(dst.get(), src.get());
+    measure_constant<16>(dst.get(), src.get());
+    measure_constant<24>(dst.get(), src.get());
+    measure_constant<32>(dst.get(), src.get());
+    measure_constant<48>(dst.get(), src.get());
+    measure_constant<64>(dst.get(), src.get());
+    cout << endl;
+
+    return 0;
+}
+
+namespace {
+
+    template<typename COPY>
+    auto measure(uint8_t* _dst, const uint8_t* _src, uint64_t _size, COPY&& _copy) -> int64_t {
+        const auto iterations = k_bytes_per_point / _size;
+        const auto span       = k_buffer_size - _size;
+        auto       offset     = uint64_t{0};
+
+        auto start_time = high_resolution_clock::now();
+        for (auto i = 0ull; i < iterations; ++i) {
+            _copy(_dst + offset, _src + offset, _size);
+            g_sink = _dst[offset];
+            offset += _size + 64;
+            if (offset > span) {
+                offset = (offset & 63) + 1;  // keep moving the misalignment
+            }
+        }
+        return duration_cast<nanoseconds>(high_resolution_clock::now() - start_time).count();
+    }
+
+    template<uint64_t SIZE>
+    void measure_constant(uint8_t* _dst, const uint8_t* _src) {
+        auto memcpy_ns = measure(_dst, _src, SIZE, [](uint8_t* _d, const uint8_t* _s, uint64_t) { memcpy(_d, _s, SIZE); });
+        auto memops_ns = measure(_dst, _src, SIZE, [](uint8_t* _d, const uint8_t* _s, uint64_t) { memops::copy(_d, _s, SIZE); });
+
+        auto total = k_bytes_per_point / SIZE * SIZE;
+        cout << setw(10) << SIZE                                        //
+             << " | " << setw(14) << format_throughput(total, memcpy_ns)  //
+             << " | " << setw(14) << format_throughput(total, memops_ns)  //
+             << " | x" << fixed << setprecision(2) << (double)memcpy_ns / (double)memops_ns << "\n";
+    }
+
+}  // namespace
@@ -0,0 +1,110 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages = uint64_t{10'000'000};
+
+// local tests
+
+namespace {
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> int64_t;
+
+    template<uint64_t CAPACITY>
+    void report();
+
+}
+
+// main procedure
+//
+// Producer and consumer threads exchange 16 byte records (packed write/read) through queues of the same capacity:
+// ● runtime: `tx_queue_sp_t`, the capacity is a member copied by every transaction
+// ● fixed heap: `tx_queue_sp_fixed_t` with allocated storage, the masks are constants
+// ● fixed inline: `tx_queue_sp_fixed_t` with the storage right after the status lines
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << "\n\n";
+
+    report<4_KiB>();
+    report<64_KiB>();
+    report<1_MiB>();
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> int64_t {
+        if (!_queue) {
+            return -1;
+        }
+
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx     = tx_read_t(_queue);
+                auto [a, b] = tx.template read<uint64_t, uint64_t>();
+                if (tx) {
+                    errors += a != i || b != i * 3;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (auto tx = tx_write_t(_queue); tx.write(i, i * 3)) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    template<uint64_t CAPACITY>
+    void report() {
+        auto runtime      = make_unique<tx_queue_sp_t<>>(CAPACITY);
+        auto fixed_heap   = make_unique<tx_queue_sp_fixed_t<CAPACITY, tx_storage_t::HEAP>>();
+        auto fixed_inline = make_unique<tx_queue_sp_fixed_t<CAPACITY, tx_storage_t::INLINE>>();
+
+        const auto runtime_ns      = transmision(*runtime);
+        const auto fixed_heap_ns   = transmision(*fixed_heap);
+        const auto fixed_inline_ns = transmision(*fixed_inline);
+        if (runtime_ns < 0 || fixed_heap_ns < 0 || fixed_inline_ns < 0) {
+            cout << "Error: transmission failed with a capacity of " << format_size(CAPACITY) << "\n";
+            return;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  capacity " << setw(12) << format_size(CAPACITY)                                     //
+             << " | runtime " << fixed << setprecision(2) << setw(8) << rate(runtime_ns) << " Mmsg/s"  //
+             << " | fixed heap " << setw(8) << rate(fixed_heap_ns) << " Mmsg/s"                        //
+             << " | fixed inline " << setw(8) << rate(fixed_inline_ns) << " Mmsg/s"                    //
+             << " | speedup x" << (double)runtime_ns / (double)fixed_heap_ns << " / x" << (double)runtime_ns / (double)fixed_inline_ns << "\n";
+    }
+
+}  // namespace
@@ -0,0 +1,119 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+#include "utest_jobs.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace chrono;
+using namespace chrono_literals;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_sample_size = (uint64_t)512_MiB;
+constexpr auto k_queue_size  = (uint64_t)64_MiB;
+
+// local tests
+
+namespace {
+
+    auto transmision(tx_storage_t _storage, const uint8_t* _sample_data, uint64_t _chunk_size, tx_pages_t& _pages) -> int64_t;
+    auto pages_name(tx_pages_t _pages) -> const char*;
+
+}
+
+// main procedure
+//
+// A 64 MiB ring spans 16384 regular pages, far more than the dTLB holds, hence every few KiB the producer and the
+// consumer miss it. With 2 MiB pages the same ring is 32 pages
+
+auto main() -> int {
+    // generate random data
+
+    auto sample_data = make_unique<uint8_t[]>(k_sample_size);
+    auto rd          = random_device{};
+    auto gen         = mt19937(rd());
+    auto dis_byte    = uniform_int_distribution<>(0, 255);
+
+    cout << "== Generating random data...\n";
+    for (auto i = 0u; i < k_sample_size; ++i) {
+        sample_data[i] = (uint8_t)dis_byte(gen);
+    }
+
+    // sweep chunk sizes
+
+    const uint64_t chunk_sizes[] = {256, 4_KiB, 64_KiB, 1_MiB};
+
+    auto results = stringstream{};
+    auto pages   = tx_pages_t::REGULAR;
+    for (auto chunk_size : chunk_sizes) {
+        auto regular_pages = tx_pages_t::REGULAR;
+        auto regular_ns    = transmision(tx_storage_t::HEAP, sample_data.get(), chunk_size, regular_pages);
+        auto huge_ns       = transmision(tx_storage_t::HUGE_PAGES, sample_data.get(), chunk_size, pages);
+        if (regular_ns < 0 || huge_ns < 0) {
+            cout << "Error: cannot create the queue\n";
+            return 1;
+        }
+
+        results << "  chunk size " << setw(12) << format_size(chunk_size)                         //
+                << " | 4 KiB pages " << setw(14) << format_throughput(k_sample_size, regular_ns)  //
+                << " | 2 MiB pages " << setw(14) << format_throughput(k_sample_size, huge_ns)     //
+                << " | speedup x" << fixed << setprecision(2) << (double)regular_ns / (double)huge_ns << "\n";
+    }
+
+    cout << "\n== Stats...\n\n";
+    cout << "          data sample size: " << format_size(k_sample_size) << "\n";
+    cout << "                queue size: " << format_size(k_queue_size) << "\n";
+    cout << "        huge pages backing: " << pages_name(pages) << "\n\n";
+    cout << results.str() << endl;
+
+    return 0;
+}
+
+namespace {
+
+    auto transmision(tx_storage_t _storage, const uint8_t* _sample_data, uint64_t _chunk_size, tx_pages_t& _pages) -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size, _storage);
+        if (!queue) {
+            return -1;
+        }
+        _pages = queue.pages();
+
+        const auto start_time   = high_resolution_clock::now() + 100ms;
+        auto       producer_job = utest_job_transmit_buffer<decltype(queue)>(queue);
+        auto       consumer_job = utest_job_receive_buffer<decltype(queue)>(queue);
+
+        producer_job.set_data(_sample_data, k_sample_size);
+        producer_job.set_minmax_chunk_size(_chunk_size, _chunk_size);
+        producer_job.set_start_time(start_time);
+        consumer_job.set_start_time(start_time);
+
+        producer_job.start();
+        consumer_job.start();
+
+        producer_job.wait_to_complete();
+        consumer_job.wait_to_complete();
+
+        return max(producer_job.get_total_duration_ns(), consumer_job.get_total_duration_ns());
+    }
+
+    auto pages_name(tx_pages_t _pages) -> const char* {
+        switch (_pages) {
+            case tx_pages_t::EXPLICIT_HUGE: return "explicit (MAP_HUGETLB / MEM_LARGE_PAGES)";
+            case tx_pages_t::TRANSPARENT_HUGE: return "transparent (madvise, no explicit ones available)";
+            default: return "regular (no huge pages available)";
+        }
+    }
+
+}  // namespace
@@ -20,8 +20,8 @@ using namespace std;
 namespace {
 
     template<qcstudio::everification VERIFICATION = NONE>
-    auto transmision(tx_queue_mp_t& _queue) -> int;
-    auto interactive(tx_queue_mp_t& _queue) -> int;
+    auto transmision(tx_queue_mp_t<>& _queue) -> int;
+    auto interactive(tx_queue_mp_t<>& _queue) -> int;
 
 }
 
@@ -53,7 +53,7 @@ auto main(int _argc, const char* _argv[]) -> int {
     // check
 
     if (!queue) {
-        cout << "Error: cannot initialize the queue. Check the size (must be aligned and be power of 2) and other parameters\n";
+        cout << "Error: cannot initialize the queue. Check the size (must be aligned) and other parameters\n";
         return -1;
     }
 
@@ -89,7 +89,7 @@ auto main(int _argc, const char* _argv[]) -> int {
 namespace {
 
     template<qcstudio::everification VERIFICATION>
-    auto transmision(tx_queue_mp_t& _queue) -> int {
+    auto transmision(tx_queue_mp_t<>& _queue) -> int {
         // read the start time from the queue itself and prepare the test
 
         cout << "== Waiting for the start time..." << endl;
@@ -106,10 +106,9 @@ namespace {
             }
         } while (timestamp == 0);
 
-        auto consumer_job = utest_job_receive_buffer<tx_queue_mp_t, VERIFICATION>(_queue);
+        auto consumer_job = utest_job_receive_buffer<tx_queue_mp_t<>, VERIFICATION>(_queue);
 
         consumer_job.set_start_time(start_time);
-        consumer_job.set_max_chunk_size(k_max_chunk_size);
 
         // start the threads
 
@@ -136,7 +135,7 @@ namespace {
         return 0;
     }
 
-    auto interactive(tx_queue_mp_t& _queue) -> int {
+    auto interactive(tx_queue_mp_t<>& _queue) -> int {
         auto consumer_job = utest_job_interactive_receiver(_queue);
         consumer_job.start();
         consumer_job.wait_to_complete();
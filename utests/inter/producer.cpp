@@ -16,8 +16,8 @@ using namespace std;
 namespace {
 
     template<qcstudio::everification VERIFICATION = NONE>
-    auto transmision(tx_queue_mp_t& _queue) -> int;
-    auto interactive(tx_queue_mp_t& _queue) -> int;
+    auto transmision(tx_queue_mp_t<>& _queue) -> int;
+    auto interactive(tx_queue_mp_t<>& _queue) -> int;
 
 }
 
@@ -42,7 +42,7 @@ auto main(int _argc, const char* _argv[]) -> int {
     // check
 
     if (!queue) {
-        cout << "Error: cannot initialize the queue. Check the size (must be aligned and be power of 2) and other parameters\n";
+        cout << "Error: cannot initialize the queue. Check the size (must be aligned) and other parameters\n";
         return -1;
     }
 
@@ -77,7 +77,7 @@ auto main(int _argc, const char* _argv[]) -> int {
 
 namespace {
     template<qcstudio::everification VERIFICATION>
-    auto transmision(tx_queue_mp_t& _queue) -> int {
+    auto transmision(tx_queue_mp_t<>& _queue) -> int {
         // generate random data
 
         auto sample_data = make_unique<uint8_t[]>(k_sample_size);
@@ -135,7 +135,7 @@ namespace {
         return 0;
     }
 
-    auto interactive(tx_queue_mp_t& _queue) -> int {
+    auto interactive(tx_queue_mp_t<>& _queue) -> int {
         auto producer_job = utest_job_interactive_transmitter(_queue);
         producer_job.start();
         producer_job.wait_to_complete();
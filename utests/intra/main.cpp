@@ -15,11 +15,13 @@
 #include <random>
 #include <thread>
 
-// Windows
+// windows
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
+#if _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <Windows.h>
+#endif
 
 using namespace std;
 using namespace chrono;
@@ -37,8 +39,8 @@ constexpr auto k_max_chunk_size = (uint64_t)8_KiB;
 namespace {
 
     template<qcstudio::everification VERIFICATION = NONE>
-    auto transmision(tx_queue_sp_t& _queue) -> int;
-    auto interactive(tx_queue_sp_t& _queue) -> int;
+    auto transmision(tx_queue_sp_t<>& _queue) -> int;
+    auto interactive(tx_queue_sp_t<>& _queue) -> int;
 
 }
 
@@ -82,7 +84,7 @@ auto main(int _argc, const char* _argv[]) -> int {
 namespace {
 
     template<qcstudio::everification VERIFICATION>
-    auto transmision(tx_queue_sp_t& _queue) -> int {
+    auto transmision(tx_queue_sp_t<>& _queue) -> int {
         // generate random data
 
         auto sample_data = make_unique<uint8_t[]>(k_sample_size);
@@ -108,7 +110,6 @@ namespace {
         producer_job.set_minmax_chunk_size(147, k_max_chunk_size);
         producer_job.set_start_time(start_time);
         consumer_job.set_start_time(start_time);
-        consumer_job.set_max_chunk_size(k_max_chunk_size);
 
         // start the threads
 
@@ -122,7 +123,7 @@ namespace {
 
         // print the results
 
-        if constexpr (VERIFICATION) {
+        if constexpr (VERIFICATION != NONE) {
             cout << "producer hash : " << producer_job.get_hash_str() << endl;
             cout << "consumer hash : " << consumer_job.get_hash_str() << endl;
         }
@@ -139,7 +140,7 @@ namespace {
         cout << "        # read re-attempts: " << dec << consumer_job.get_transaction_attempts() << "\n";
         cout << endl;
 
-        if constexpr (VERIFICATION) {
+        if constexpr (VERIFICATION != NONE) {
             if (producer_job.get_hash_str() != consumer_job.get_hash_str()) {
                 cout << "Error!\n";
                 return 1;
@@ -148,7 +149,7 @@ namespace {
         return 0;
     }
 
-    auto interactive(tx_queue_sp_t& _queue) -> int {
+    auto interactive(tx_queue_sp_t<>& _queue) -> int {
         auto producer_job = qcstudio::utest_job_interactive_transmitter(_queue);
         auto consumer_job = qcstudio::utest_job_interactive_receiver(_queue);
         producer_job.start();
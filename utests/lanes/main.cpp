@@ -0,0 +1,164 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages  = uint64_t{4'000'000};  // in total, split among the active producers
+constexpr auto k_lanes     = uint32_t{64};
+constexpr auto k_lane_size = (uint64_t)64_KiB;
+
+// local tests
+
+namespace {
+
+    auto lane_set(uint64_t _producers) -> int64_t;
+    auto polling(uint64_t _producers) -> int64_t;
+
+}
+
+// main procedure
+//
+// N active producer threads send 16 byte records to one consumer thread, which checks the per-producer order.
+// All the 64 lanes are registered, the rest of them stay idle:
+// ● lane set: one `tx_lane_set_t`, the consumer drains the flagged lanes
+// ● polling: one `tx_queue_sp_t` per lane, the consumer tries all of them round-robin
+
+auto main() -> int {
+    const auto max_producers = max(1u, thread::hardware_concurrency() - 1);
+
+    cout << "== Messages: " << k_messages << ", lanes: " << k_lanes << ", lane size: " << format_size(k_lane_size) << "\n\n";
+
+    for (auto producers = uint64_t{1}; producers <= max_producers && producers <= k_lanes; producers *= 2) {
+        const auto set_ns     = lane_set(producers);
+        const auto polling_ns = polling(producers);
+        if (set_ns < 0 || polling_ns < 0) {
+            cout << "Error: transmission failed with " << producers << " producers\n";
+            return 1;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  active producers " << setw(3) << producers                                       //
+             << " | lane set " << fixed << setprecision(2) << setw(8) << rate(set_ns) << " Mmsg/s"  //
+             << " | polling " << setw(8) << rate(polling_ns) << " Mmsg/s"                           //
+             << " | speedup x" << (double)polling_ns / (double)set_ns << "\n";
+    }
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto lane_set(uint64_t _producers) -> int64_t {
+        auto set = make_unique<tx_lane_set_t<k_lanes>>(k_lane_size);
+        if (!*set) {
+            return -1;
+        }
+
+        // idle lanes: created by threads that never write (and give them back as they exit)
+
+        for (auto i = _producers; i < k_lanes; ++i) {
+            thread([&set]() { set->lane(); }).join();
+        }
+
+        const auto per_producer = k_messages / _producers;
+        const auto start_time   = high_resolution_clock::now();
+
+        auto threads = vector<thread>{};
+        for (auto p = uint64_t{0}; p < _producers; ++p) {
+            threads.emplace_back([&set, p, per_producer]() {
+                auto& lane = set->lane();
+                for (auto i = uint64_t{0}; i < per_producer;) {
+                    if (auto tx = tx_write_t(lane); tx.write(p, i)) {
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        auto expected = vector<uint64_t>(_producers, 0);
+        auto errors   = uint64_t{0};
+        for (auto received = uint64_t{0}; received < per_producer * _producers;) {
+            received += set->drain([&](auto& _tx) {
+                if (auto [p, i] = _tx.template read<uint64_t, uint64_t>(); _tx) {
+                    errors += p >= _producers || i != expected[p]++;
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    auto polling(uint64_t _producers) -> int64_t {
+        auto queues = vector<unique_ptr<tx_queue_sp_t<>>>{};
+        for (auto i = 0u; i < k_lanes; ++i) {
+            queues.push_back(make_unique<tx_queue_sp_t<>>(k_lane_size));
+            if (!*queues.back()) {
+                return -1;
+            }
+        }
+
+        const auto per_producer = k_messages / _producers;
+        const auto start_time   = high_resolution_clock::now();
+
+        auto threads = vector<thread>{};
+        for (auto p = uint64_t{0}; p < _producers; ++p) {
+            threads.emplace_back([&queue = *queues[p], p, per_producer]() {
+                for (auto i = uint64_t{0}; i < per_producer;) {
+                    if (auto tx = tx_write_t(queue); tx.write(p, i)) {
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        auto expected = vector<uint64_t>(_producers, 0);
+        auto errors   = uint64_t{0};
+        for (auto received = uint64_t{0}; received < per_producer * _producers;) {
+            for (auto& queue : queues) {
+                for (auto n = 0; n < 16; ++n) {  // same budget as `drain`
+                    auto tx     = tx_read_t(*queue);
+                    auto [p, i] = tx.template read<uint64_t, uint64_t>();
+                    if (!tx) {
+                        break;
+                    }
+                    errors += p >= _producers || i != expected[p]++;
+                    ++received;
+                }
+            }
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+}  // namespace
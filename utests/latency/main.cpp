@@ -0,0 +1,116 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages = uint64_t{2'000'000};
+
+// local tests
+
+namespace {
+
+    using queue_t = tx_queue_sp_t<tx_wait_yield_t, tx_layout_shadow_t, tx_stats_latency_t>;
+
+    auto transmision(queue_t& _queue, uint64_t _interval_ns) -> bool;
+
+    template<uint64_t CAPACITY>
+    void report(uint64_t _interval_ns);
+
+}
+
+// main procedure
+//
+// Producer and consumer threads exchange 16 byte records through `tx_queue_sp_t` in latency mode
+// (`tx_stats_latency_t`): every write is stamped with the TSC on commit and every read records how long the record
+// waited in the queue
+// ● saturated: the producer writes as fast as it can, the latency is mostly the time to drain a full queue
+// ● paced: one record every 1/10 µs (TSC spin), the latency is the cross-core hand-off plus the consumer hiccups
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << ", TSC " << fixed << setprecision(3) << tsc::ticks_per_ns() << " ticks/ns\n\n";
+
+    report<4_KiB>(0);
+    report<64_KiB>(0);
+    report<4_KiB>(1'000);
+    report<64_KiB>(1'000);
+    report<4_KiB>(10'000);
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto transmision(queue_t& _queue, uint64_t _interval_ns) -> bool {
+        if (!_queue) {
+            return false;
+        }
+
+        auto errors   = uint64_t{0};
+        auto consumer = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx     = tx_read_t(_queue);
+                auto [a, b] = tx.read<uint64_t, uint64_t>();
+                if (tx) {
+                    errors += a != i || b != i * 3;
+                    ++i;
+                }
+            }
+        });
+
+        const auto interval = (uint64_t)((double)_interval_ns * tsc::ticks_per_ns());
+        auto       next     = tsc::now();
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (interval) {
+                while (tsc::now() < next) {
+                    _mm_pause();
+                }
+            }
+            if (auto tx = tx_write_t(_queue); tx.write(i, i * 3)) {
+                next += interval;
+                ++i;
+            }
+        }
+
+        consumer.join();
+        return errors == 0;
+    }
+
+    template<uint64_t CAPACITY>
+    void report(uint64_t _interval_ns) {
+        auto queue = make_unique<queue_t>(CAPACITY);
+        if (!transmision(*queue, _interval_ns)) {
+            cout << "Error: transmission failed with a capacity of " << format_size(CAPACITY) << "\n";
+            return;
+        }
+
+        const auto latency = queue->latency();
+        const auto mode    = _interval_ns ? "paced " + to_string(_interval_ns) + " ns" : string("saturated");
+        const auto us      = [](double _ns) { return _ns / 1e3; };
+
+        cout << "  capacity " << setw(12) << format_size(CAPACITY) << " | " << setw(16) << left << mode << right  //
+             << " | records " << latency.count                                                                   //
+             << " | p50 " << fixed << setprecision(2) << setw(10) << us(latency.p50) << " us"                   //
+             << " | p99 " << setw(10) << us(latency.p99) << " us"                                               //
+             << " | p99.9 " << setw(10) << us(latency.p999) << " us"                                            //
+             << " | max " << setw(10) << us(latency.max) << " us\n";
+    }
+
+}  // namespace
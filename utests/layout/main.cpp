@@ -0,0 +1,196 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+// linux
+
+#if !_WIN32
+#    include <linux/perf_event.h>
+#endif
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages = uint64_t{10'000'000};
+
+// local tests
+
+namespace {
+
+    // L1D read misses of the calling thread (linux perf counters; not available on windows or without a PMU)
+
+    class miss_counter_t {
+    public:
+        miss_counter_t();
+        ~miss_counter_t();
+
+        auto read() const -> int64_t;  // -1 if not available
+
+    private:
+        int fd_ = -1;
+    };
+
+    struct result_t {
+        int64_t ns     = -1;
+        int64_t misses = -1;  // both sides
+    };
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> result_t;
+
+    template<uint64_t CAPACITY>
+    void report();
+
+}
+
+// main procedure
+//
+// Producer and consumer threads exchange 16 byte records through `tx_queue_sp_t` with each status layout:
+// ● compact: every transaction loads the index of the other side (a line transfer whenever it moved)
+// ● shadow: transactions start from a shadow of the remote index kept in their own line
+// ● padded: shadows, and 128 byte lines (no adjacent-line prefetch of the other side's line)
+//
+// Cross-core line transfers show up as L1D misses: the records cost the same on every layout (a line every 4
+// records), the rest comes from the status lines
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << "\n\n";
+
+    report<4_KiB>();
+    report<64_KiB>();
+    report<1_MiB>();
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+#if _WIN32
+    miss_counter_t::miss_counter_t() {
+    }
+
+    miss_counter_t::~miss_counter_t() {
+    }
+
+    auto miss_counter_t::read() const -> int64_t {
+        return -1;
+    }
+#else
+    miss_counter_t::miss_counter_t() {
+        auto attributes = perf_event_attr{};
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.type           = PERF_TYPE_HW_CACHE;
+        attributes.size           = sizeof(attributes);
+        attributes.config         = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+        fd_                       = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);  // this thread, any core
+    }
+
+    miss_counter_t::~miss_counter_t() {
+        if (fd_ != -1) {
+            close(fd_);
+        }
+    }
+
+    auto miss_counter_t::read() const -> int64_t {
+        auto value = uint64_t{0};
+        if (fd_ == -1 || ::read(fd_, &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+        return (int64_t)value;
+    }
+#endif
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> result_t {
+        if (!_queue) {
+            return {};
+        }
+
+        auto errors          = uint64_t{0};
+        auto consumer_misses = int64_t{-1};
+        auto start_time      = high_resolution_clock::now();
+        auto consumer        = thread([&]() {
+            const auto counter = miss_counter_t();
+            const auto start   = counter.read();
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx     = tx_read_t(_queue);
+                auto [a, b] = tx.template read<uint64_t, uint64_t>();
+                if (tx) {
+                    errors += a != i || b != i * 3;
+                    ++i;
+                }
+            }
+            if (start >= 0) {
+                consumer_misses = counter.read() - start;
+            }
+        });
+
+        const auto counter = miss_counter_t();
+        const auto start   = counter.read();
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (auto tx = tx_write_t(_queue); tx.write(i, i * 3)) {
+                ++i;
+            }
+        }
+        const auto producer_misses = start >= 0 ? counter.read() - start : -1;
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        if (errors) {
+            return {};
+        }
+        return {duration_cast<nanoseconds>(end_time - start_time).count(), producer_misses >= 0 && consumer_misses >= 0 ? producer_misses + consumer_misses : -1};
+    }
+
+    template<uint64_t CAPACITY>
+    void report() {
+        auto compact = make_unique<tx_queue_sp_t<tx_wait_yield_t, tx_layout_compact_t>>(CAPACITY);
+        auto shadow  = make_unique<tx_queue_sp_t<tx_wait_yield_t, tx_layout_shadow_t>>(CAPACITY);
+        auto padded  = make_unique<tx_queue_sp_t<tx_wait_yield_t, tx_layout_padded_t>>(CAPACITY);
+
+        const auto compact_result = transmision(*compact);
+        const auto shadow_result  = transmision(*shadow);
+        const auto padded_result  = transmision(*padded);
+        if (compact_result.ns < 0 || shadow_result.ns < 0 || padded_result.ns < 0) {
+            cout << "Error: transmission failed with a capacity of " << format_size(CAPACITY) << "\n";
+            return;
+        }
+
+        const auto rate   = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+        const auto misses = [](int64_t _misses) {
+            auto result = ostringstream{};
+            if (_misses < 0) {
+                result << "     n/a";
+            } else {
+                result << fixed << setprecision(2) << setw(8) << (double)_misses / (double)k_messages;
+            }
+            return result.str() + " miss/msg";
+        };
+
+        cout << "  capacity " << setw(12) << format_size(CAPACITY)                                                                              //
+             << " | compact " << fixed << setprecision(2) << setw(8) << rate(compact_result.ns) << " Mmsg/s " << misses(compact_result.misses)  //
+             << " | shadow " << setw(8) << rate(shadow_result.ns) << " Mmsg/s " << misses(shadow_result.misses)                                 //
+             << " | padded " << setw(8) << rate(padded_result.ns) << " Mmsg/s " << misses(padded_result.misses) << "\n";
+    }
+
+}  // namespace
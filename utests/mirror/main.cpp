@@ -0,0 +1,106 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+#include "utest_jobs.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace chrono;
+using namespace chrono_literals;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_sample_size = (uint64_t)256_MiB;
+constexpr auto k_queue_size  = (uint64_t)64_KiB;  // = allocation granularity on Windows, so both storages have the same capacity
+
+// local tests
+
+namespace {
+
+    auto transmision(tx_storage_t _storage, const uint8_t* _sample_data, uint64_t _chunk_size) -> int64_t;
+
+}
+
+// main procedure
+//
+// Chunk sizes close to the queue capacity make almost every transaction wrap around the end
+// of the storage, which is the worst case for `HEAP` storage and the best case for `MIRRORED`
+
+auto main() -> int {
+    // generate random data
+
+    auto sample_data = make_unique<uint8_t[]>(k_sample_size);
+    auto rd          = random_device{};
+    auto gen         = mt19937(rd());
+    auto dis_byte    = uniform_int_distribution<>(0, 255);
+
+    cout << "== Generating random data...\n";
+    for (auto i = 0u; i < k_sample_size; ++i) {
+        sample_data[i] = (uint8_t)dis_byte(gen);
+    }
+
+    // sweep chunk sizes (the 8 bytes are the chunk size header written by the producer)
+
+    const uint64_t chunk_sizes[] = {k_queue_size / 4, k_queue_size / 2, k_queue_size * 3 / 4, k_queue_size - 1_KiB, k_queue_size - 8 - 1};
+
+    auto results = stringstream{};
+    for (auto chunk_size : chunk_sizes) {
+        auto heap_ns     = transmision(tx_storage_t::HEAP, sample_data.get(), chunk_size);
+        auto mirrored_ns = transmision(tx_storage_t::MIRRORED, sample_data.get(), chunk_size);
+        if (heap_ns < 0 || mirrored_ns < 0) {
+            cout << "Error: cannot create the queue\n";
+            return 1;
+        }
+
+        results << "  chunk size " << setw(12) << format_size(chunk_size)                 //
+                << " | heap " << setw(14) << format_throughput(k_sample_size, heap_ns)         //
+                << " | mirrored " << setw(14) << format_throughput(k_sample_size, mirrored_ns)  //
+                << " | speedup x" << fixed << setprecision(2) << (double)heap_ns / (double)mirrored_ns << "\n";
+    }
+
+    cout << "\n== Stats...\n\n";
+    cout << "          data sample size: " << format_size(k_sample_size) << "\n";
+    cout << "                queue size: " << format_size(k_queue_size) << "\n\n";
+    cout << results.str() << endl;
+
+    return 0;
+}
+
+namespace {
+
+    auto transmision(tx_storage_t _storage, const uint8_t* _sample_data, uint64_t _chunk_size) -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size, _storage);
+        if (!queue || queue.capacity() != k_queue_size) {
+            return -1;
+        }
+
+        const auto start_time   = high_resolution_clock::now() + 100ms;
+        auto       producer_job = utest_job_transmit_buffer<decltype(queue)>(queue);
+        auto       consumer_job = utest_job_receive_buffer<decltype(queue)>(queue);
+
+        producer_job.set_data(_sample_data, k_sample_size);
+        producer_job.set_minmax_chunk_size(_chunk_size, _chunk_size);
+        producer_job.set_start_time(start_time);
+        consumer_job.set_start_time(start_time);
+
+        producer_job.start();
+        consumer_job.start();
+
+        producer_job.wait_to_complete();
+        consumer_job.wait_to_complete();
+
+        return max(producer_job.get_total_duration_ns(), consumer_job.get_total_duration_ns());
+    }
+
+}  // namespace
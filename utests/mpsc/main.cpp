@@ -0,0 +1,154 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages   = uint64_t{8'000'000};  // in total, split among the producers
+constexpr auto k_queue_size = (uint64_t)1_MiB;
+constexpr auto k_record     = tx_record_t<uint64_t, uint64_t, uint64_t, uint64_t>::size;  // producer, sequence, 2 x payload
+
+// local tests
+
+namespace {
+
+    auto shared_ring(uint64_t _producers) -> int64_t;
+    auto lane_per_producer(uint64_t _producers) -> int64_t;
+
+}
+
+// main procedure
+//
+// N producer threads send 32 byte records to one consumer thread, which checks the per-producer order:
+// ● shared ring: one `tx_queue_mpsc_t`
+// ● lane per producer: one `tx_queue_sp_t` per producer, polled round-robin by the consumer
+
+auto main() -> int {
+    const auto max_producers = max(1u, thread::hardware_concurrency() - 1);
+
+    cout << "== Messages: " << k_messages << ", queue size: " << format_size(k_queue_size) << ", record size: " << k_record << " bytes\n\n";
+
+    for (auto producers = uint64_t{1}; producers <= max_producers; producers *= 2) {
+        const auto shared_ns = shared_ring(producers);
+        const auto lanes_ns  = lane_per_producer(producers);
+        if (shared_ns < 0 || lanes_ns < 0) {
+            cout << "Error: transmission failed with " << producers << " producers\n";
+            return 1;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  producers " << setw(3) << producers                                                   //
+             << " | shared ring " << fixed << setprecision(2) << setw(8) << rate(shared_ns) << " Mmsg/s"  //
+             << " | lane per producer " << setw(8) << rate(lanes_ns) << " Mmsg/s"                        //
+             << " | speedup x" << (double)lanes_ns / (double)shared_ns << "\n";
+    }
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto shared_ring(uint64_t _producers) -> int64_t {
+        auto queue = tx_queue_mpsc_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        const auto per_producer = k_messages / _producers;
+        const auto start_time   = high_resolution_clock::now();
+
+        auto threads = vector<thread>{};
+        for (auto p = uint64_t{0}; p < _producers; ++p) {
+            threads.emplace_back([&queue, p, per_producer]() {
+                for (auto i = uint64_t{0}; i < per_producer;) {
+                    if (auto tx = tx_write_t(queue, k_record); tx.write(p, i, i * 3, i * 5)) {
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        auto errors = uint64_t{0};
+        auto next   = vector<uint64_t>(_producers, 0);
+        for (auto received = uint64_t{0}; received < per_producer * _producers;) {
+            auto tx           = tx_read_t(queue);
+            auto [p, i, a, b] = tx.read<uint64_t, uint64_t, uint64_t, uint64_t>();
+            if (tx) {
+                errors += p >= _producers || next[p]++ != i || a != i * 3 || b != i * 5;
+                ++received;
+            }
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count() * (int64_t)k_messages / (int64_t)(per_producer * _producers);
+    }
+
+    auto lane_per_producer(uint64_t _producers) -> int64_t {
+        auto lanes = vector<unique_ptr<tx_queue_sp_t<>>>{};
+        for (auto p = uint64_t{0}; p < _producers; ++p) {
+            lanes.push_back(make_unique<tx_queue_sp_t<>>(k_queue_size / _producers));  // same memory as the shared ring
+            if (!*lanes.back()) {
+                return -1;
+            }
+        }
+
+        const auto per_producer = k_messages / _producers;
+        const auto start_time   = high_resolution_clock::now();
+
+        auto threads = vector<thread>{};
+        for (auto p = uint64_t{0}; p < _producers; ++p) {
+            threads.emplace_back([&lane = *lanes[p], p, per_producer]() {
+                for (auto i = uint64_t{0}; i < per_producer;) {
+                    if (auto tx = tx_write_t(lane); tx.write(p, i, i * 3, i * 5)) {
+                        ++i;
+                    }
+                }
+            });
+        }
+
+        auto errors = uint64_t{0};
+        auto next   = vector<uint64_t>(_producers, 0);
+        for (auto received = uint64_t{0}; received < per_producer * _producers;) {
+            for (auto& lane : lanes) {
+                auto tx           = tx_read_t(*lane);
+                auto [p, i, a, b] = tx.read<uint64_t, uint64_t, uint64_t, uint64_t>();
+                if (tx) {
+                    errors += p >= _producers || next[p]++ != i || a != i * 3 || b != i * 5;
+                    ++received;
+                }
+            }
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count() * (int64_t)k_messages / (int64_t)(per_producer * _producers);
+    }
+
+}  // namespace
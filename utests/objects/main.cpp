@@ -0,0 +1,197 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages   = uint64_t{5'000'000};
+constexpr auto k_slots      = uint64_t{4096};
+constexpr auto k_queue_size = (uint64_t)256_KiB;
+
+// local tests
+
+namespace {
+
+    struct order_t {
+        uint64_t id;
+        double   price;
+        uint32_t quantity;
+        uint8_t  side;
+    };
+
+    auto orders_object_queue() -> int64_t;
+    auto orders_byte_queue() -> int64_t;
+    auto strings_object_queue() -> int64_t;
+    auto strings_byte_queue() -> int64_t;
+    void report(const char* _name, int64_t _objects_ns, int64_t _bytes_ns);
+
+}
+
+// main procedure
+//
+// One producer sends objects to one consumer:
+// ● orders: a trivially copyable struct, constructed in place vs written as bytes
+// ● strings: moved through the slots vs serialized (size + characters) and rebuilt by the consumer
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << ", slots: " << k_slots << ", byte queue size: " << format_size(k_queue_size) << "\n\n";
+
+    report("orders", orders_object_queue(), orders_byte_queue());
+    report("strings", strings_object_queue(), strings_byte_queue());
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto make_text(uint64_t _i) -> string {
+        return "message #" + to_string(_i) + " with a tail that does not fit in SSO";
+    }
+
+    auto orders_object_queue() -> int64_t {
+        auto queue      = make_unique<tx_object_queue_t<order_t, k_slots>>();
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                if (auto order = queue->pop()) {
+                    errors += order->id != i || order->quantity != (uint32_t)i;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (queue->emplace(order_t{i, (double)i, (uint32_t)i, (uint8_t)(i & 1)})) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    auto orders_byte_queue() -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx    = tx_read_t(queue);
+                auto order = order_t{};
+                if (tx.read(order)) {
+                    errors += order.id != i || order.quantity != (uint32_t)i;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (auto tx = tx_write_t(queue); tx.write(order_t{i, (double)i, (uint32_t)i, (uint8_t)(i & 1)})) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    auto strings_object_queue() -> int64_t {
+        auto queue      = make_unique<tx_object_queue_t<string, k_slots>>();
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            auto text = string{};
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                if (queue->pop(text)) {
+                    errors += text.size() < 10;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (queue->emplace(make_text(i))) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    auto strings_byte_queue() -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx   = tx_read_t(queue);
+                auto size = uint64_t{};
+                if (!tx.read(size)) {
+                    continue;
+                }
+                auto text = string(size, '\0');
+                if (tx.read(text.data(), size)) {
+                    errors += text.size() < 10;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            const auto text = make_text(i);
+            if (auto tx = tx_write_t(queue); tx.write((uint64_t)text.size()) && tx.write(text)) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    void report(const char* _name, int64_t _objects_ns, int64_t _bytes_ns) {
+        if (_objects_ns < 0 || _bytes_ns < 0) {
+            cout << "Error: transmission of " << _name << " failed\n";
+            return;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  " << setw(8) << _name                                                                     //
+             << " | object queue " << fixed << setprecision(2) << setw(8) << rate(_objects_ns) << " Mmsg/s"  //
+             << " | byte queue " << setw(8) << rate(_bytes_ns) << " Mmsg/s"                                  //
+             << " | speedup x" << (double)_bytes_ns / (double)_objects_ns << "\n";
+    }
+
+}  // namespace
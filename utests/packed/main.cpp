@@ -0,0 +1,126 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_records    = uint64_t{50'000'000};
+constexpr auto k_queue_size = (uint64_t)64_KiB;
+
+// global data
+
+volatile uint64_t g_sink;  // keeps the reads alive
+
+// local tests
+
+namespace {
+
+    auto per_field() -> int64_t;
+    auto packed() -> int64_t;
+
+}
+
+// main procedure
+//
+// Write and read back a 5-field header (23 bytes) in the same thread, field by field vs one variadic
+// call (one space check and one packed copy). The queue stays in L1, hence it measures the fixed costs only
+
+auto main() -> int {
+    const auto per_field_ns = per_field();
+    const auto packed_ns    = packed();
+    if (per_field_ns < 0 || packed_ns < 0) {
+        cout << "Error: transmission failed\n";
+        return 1;
+    }
+
+    const auto ns_per_record = [](int64_t _ns) { return (double)_ns / (double)k_records; };
+
+    cout << "== Records: " << k_records << ", record size: " << tx_record_t<uint64_t, uint64_t, uint32_t, uint16_t, uint8_t>::size << " bytes\n\n";
+    cout << fixed << setprecision(2);
+    cout << "  per field " << setw(8) << ns_per_record(per_field_ns) << " ns/record\n";
+    cout << "     packed " << setw(8) << ns_per_record(packed_ns) << " ns/record | speedup x" << (double)per_field_ns / (double)packed_ns << "\n";
+    cout << endl;
+
+    return 0;
+}
+
+namespace {
+
+    auto per_field() -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto       checksum   = uint64_t{0};
+        const auto start_time = high_resolution_clock::now();
+        for (auto i = uint64_t{0}; i < k_records; ++i) {
+            {
+                auto tx = tx_write_t(queue);
+                tx.write(i);
+                tx.write(i * 3);
+                tx.write((uint32_t)i);
+                tx.write((uint16_t)i);
+                tx.write((uint8_t)i);
+            }
+            {
+                auto tx   = tx_read_t(queue);
+                auto seq  = uint64_t{}, ts = uint64_t{};
+                auto id   = uint32_t{};
+                auto kind = uint16_t{};
+                auto side = uint8_t{};
+                if (!tx.read(seq) || !tx.read(ts) || !tx.read(id) || !tx.read(kind) || !tx.read(side)) {
+                    return -1;
+                }
+                checksum += seq + ts + id + kind + side;
+            }
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        g_sink = checksum;
+        return duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    auto packed() -> int64_t {
+        auto queue = tx_queue_sp_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto       checksum   = uint64_t{0};
+        const auto start_time = high_resolution_clock::now();
+        for (auto i = uint64_t{0}; i < k_records; ++i) {
+            {
+                auto tx = tx_write_t(queue);
+                tx.write(i, i * 3, (uint32_t)i, (uint16_t)i, (uint8_t)i);
+            }
+            {
+                auto tx                        = tx_read_t(queue);
+                auto [seq, ts, id, kind, side] = tx.read<uint64_t, uint64_t, uint32_t, uint16_t, uint8_t>();
+                if (!tx) {
+                    return -1;
+                }
+                checksum += seq + ts + id + kind + side;
+            }
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        g_sink = checksum;
+        return duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+}  // namespace
@@ -0,0 +1,281 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "shared-memory.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_queue_size = (uint64_t)4_KiB;    // nearly empty all the time: one message in flight
+constexpr auto k_warmup     = uint64_t{100'000};  // most round trips not recorded (caches, branch predictors, frequency)
+constexpr auto k_spins      = uint64_t{1} << 14;  // failed transactions before giving the core away once
+constexpr auto k_stop       = UINT64_MAX;         // sequence that ends the pong side
+constexpr auto k_segment    = L"3f0b9a1c5e7d4c2a8b6e9d1f0a2c4e6b";
+
+// local types and tests
+
+namespace {
+
+    struct message_t {
+        uint64_t sequence;
+        uint64_t stamp;  // TSC of the ping side as it sent it
+        uint8_t  payload[48];
+    };
+    static_assert(sizeof(message_t) == 64);
+
+    using mp_queue_t = tx_queue_mp_t<>;
+
+    template<typename QTYPE>
+    void send(QTYPE& _queue, const message_t& _message);
+
+    template<typename QTYPE>
+    auto receive(QTYPE& _queue) -> message_t;
+
+    template<typename QTYPE>
+    auto ping(QTYPE& _out, QTYPE& _in, uint64_t _warmup, uint64_t _round_trips, tx_histogram_t& _histogram) -> bool;
+
+    template<typename QTYPE>
+    void pong(QTYPE& _in, QTYPE& _out);
+
+    auto threads(uint64_t _warmup, uint64_t _round_trips, int _ping_core, int _pong_core) -> int;
+    auto process(bool _ping, uint64_t _warmup, uint64_t _round_trips, int _core) -> int;
+    void report(const tx_histogram_t& _histogram);
+
+}
+
+// main procedure
+//
+// A 64 byte message bounces between two pinned threads (two `tx_queue_sp_t`, one per direction) or two processes (two
+// `tx_queue_mp_t` in one shared memory segment). The ping side stamps every message with the TSC and, as the echo
+// comes back, records half the round trip: the one-way latency of a single message through a nearly empty queue,
+// transaction costs of both ends included
+//
+// The warm-up is a tenth of the round trips, up to `k_warmup`
+//
+// Both sides spin on their transactions (no waiting strategy): each needs a core of its own. The threads mode refuses
+// to run on a single core, and both modes give the core away after `k_spins` failed transactions, so two processes
+// sharing one still make progress (with meaningless figures)
+//
+// usage:
+// ● pingpong [-n round_trips] [-c ping_core:pong_core]  threads of this process (default cores 0:1)
+// ● pingpong ping [-n round_trips] [-c core]           the measuring process (start it first)
+// ● pingpong pong [-c core]                            the echoing process
+
+auto main(int _argc, const char* _argv[]) -> int {
+    auto role        = string_view{};
+    auto round_trips = uint64_t{1'000'000};
+    auto ping_core   = 0;
+    auto pong_core   = 1;
+    auto core        = -1;
+    for (auto i = 1; i < _argc; ++i) {
+        const auto arg = string_view(_argv[i]);
+        if (arg == "ping" || arg == "pong") {
+            role = arg;
+        } else if (arg == "-n" && i + 1 < _argc) {
+            round_trips = max<uint64_t>(strtoull(_argv[++i], nullptr, 10), 1);
+        } else if (arg == "-c" && i + 1 < _argc) {
+            const auto cores = string_view(_argv[++i]);
+            const auto colon = cores.find(':');
+            core             = atoi(_argv[i]);
+            ping_core        = core;
+            pong_core        = colon == string_view::npos ? core : atoi(_argv[i] + colon + 1);
+        } else {
+            cout << "usage: pingpong [ping|pong] [-n round_trips] [-c core | -c ping_core:pong_core]\n";
+            return -1;
+        }
+    }
+
+    if (role == "pong") {
+        return process(false, 0, 0, core);
+    }
+
+    if (role.empty() && (ping_core == pong_core || thread::hardware_concurrency() < 2)) {
+        cout << "Error: the ping and pong threads spin, they need a core each\n";
+        return -1;
+    }
+
+    const auto warmup = min(k_warmup, round_trips / 10);
+    cout << "== Round trips: " << round_trips << " (+" << warmup << " warm-up), message: " << sizeof(message_t) << " bytes, TSC " << fixed << setprecision(3) << tsc::ticks_per_ns() << " ticks/ns\n\n";
+    if (role.empty()) {
+        return threads(warmup, round_trips, ping_core, pong_core);
+    }
+    return process(true, warmup, round_trips, core);
+}
+
+namespace {
+
+    template<typename QTYPE>
+    void send(QTYPE& _queue, const message_t& _message) {
+        for (auto spins = uint64_t{1};; ++spins) {
+            if (auto tx = tx_write_t(_queue); tx.write(_message)) {
+                return;
+            }
+            if (!(spins % k_spins)) {
+                this_thread::yield();
+            }
+        }
+    }
+
+    template<typename QTYPE>
+    auto receive(QTYPE& _queue) -> message_t {
+        auto result = message_t{};
+        for (auto spins = uint64_t{1};; ++spins) {
+            if (auto tx = tx_read_t(_queue); tx.read(result)) {
+                return result;
+            }
+            if (!(spins % k_spins)) {
+                this_thread::yield();
+            }
+        }
+    }
+
+    template<typename QTYPE>
+    auto ping(QTYPE& _out, QTYPE& _in, uint64_t _warmup, uint64_t _round_trips, tx_histogram_t& _histogram) -> bool {
+        auto message = message_t{};
+        auto ok      = true;
+        for (auto i = uint64_t{0}; i < _warmup + _round_trips; ++i) {
+            message.sequence = i;
+            message.stamp    = tsc::now();
+            send(_out, message);
+
+            const auto echo = receive(_in);
+            const auto now  = tsc::now();
+            ok              = ok && echo.sequence == i && echo.stamp == message.stamp;
+            if (i >= _warmup) {
+                _histogram.record((now - echo.stamp) / 2);
+            }
+        }
+
+        message.sequence = k_stop;
+        send(_out, message);
+        return ok;
+    }
+
+    template<typename QTYPE>
+    void pong(QTYPE& _in, QTYPE& _out) {
+        while (true) {
+            const auto message = receive(_in);
+            if (message.sequence == k_stop) {
+                return;
+            }
+            send(_out, message);
+        }
+    }
+
+    auto threads(uint64_t _warmup, uint64_t _round_trips, int _ping_core, int _pong_core) -> int {
+        auto forward   = make_unique<tx_queue_sp_t<>>(k_queue_size);
+        auto backward  = make_unique<tx_queue_sp_t<>>(k_queue_size);
+        auto histogram = make_unique<tx_histogram_t>();  // zeroed
+        if (!*forward || !*backward) {
+            return -1;
+        }
+
+        auto ok          = false;
+        auto pong_thread = thread([&]() { pong(*forward, *backward); });
+        auto ping_thread = thread([&]() { ok = ping(*forward, *backward, _warmup, _round_trips, *histogram); });
+        set_thread_affinity(ping_thread, _ping_core);
+        set_thread_affinity(pong_thread, _pong_core);
+        ping_thread.join();
+        pong_thread.join();
+
+        if (!ok) {
+            cout << "Error: echoes out of order\n";
+            return -1;
+        }
+        cout << "  threads, cores " << _ping_core << ":" << _pong_core << "\n";
+        report(*histogram);
+        return 0;
+    }
+
+    auto process(bool _ping, uint64_t _warmup, uint64_t _round_trips, int _core) -> int {
+        // one segment, one queue per direction (each with its status in front)
+
+        constexpr auto queue_size = sizeof(mp_queue_t::status_t) + k_queue_size;
+
+        auto memory = unique_ptr<shared_memory>{};
+        if (_ping) {
+            memory = make_unique<shared_memory>(k_segment, 2 * queue_size);
+        } else {
+            const auto max_wait_time = 10s;
+            const auto t0            = steady_clock::now();
+            while ((!memory || !**memory) && (steady_clock::now() - t0) < max_wait_time) {
+                memory = make_unique<shared_memory>(k_segment);
+                if (!**memory) {
+                    this_thread::sleep_for(100ms);
+                }
+            }
+        }
+        if (!**memory) {
+            cout << "Error: could not " << (_ping ? "create" : "open") << " the shared memory\n";
+            return -1;
+        }
+
+        auto base     = (uint8_t*)**memory;
+        auto forward  = mp_queue_t(base, queue_size);
+        auto backward = mp_queue_t(base + queue_size, queue_size);
+        if (!forward || !backward) {
+            cout << "Error: cannot initialize the queues\n";
+            return -1;
+        }
+
+        // the pong side says hello first, so that the ping side does not time its start-up
+
+        auto ok     = true;
+        auto worker = thread([&]() {
+            if (_ping) {
+                cout << "== Waiting for the pong process...\n";
+                receive(backward);
+                auto histogram = make_unique<tx_histogram_t>();
+                ok             = ping(forward, backward, _warmup, _round_trips, *histogram);
+                if (ok) {
+                    cout << "  processes, ping core " << (_core < 0 ? string("any") : to_string(_core)) << "\n";
+                    report(*histogram);
+                }
+            } else {
+                cout << "== Echoing...\n";
+                send(backward, message_t{});
+                pong(forward, backward);
+            }
+        });
+        set_thread_affinity(worker, _core);
+        worker.join();
+
+        if (!ok) {
+            cout << "Error: echoes out of order\n";
+            return -1;
+        }
+        return 0;
+    }
+
+    void report(const tx_histogram_t& _histogram) {
+        const auto ns = [](uint64_t _ticks) { return (double)_ticks / tsc::ticks_per_ns(); };
+
+        cout << "  one-way latency (half round trip), " << _histogram.count() << " samples\n"  //
+             << fixed << setprecision(1)                                                     //
+             << "    p50    " << setw(10) << ns(_histogram.percentile(50.0)) << " ns\n"         //
+             << "    p90    " << setw(10) << ns(_histogram.percentile(90.0)) << " ns\n"         //
+             << "    p99    " << setw(10) << ns(_histogram.percentile(99.0)) << " ns\n"         //
+             << "    p99.9  " << setw(10) << ns(_histogram.percentile(99.9)) << " ns\n"         //
+             << "    p99.99 " << setw(10) << ns(_histogram.percentile(99.99)) << " ns\n"        //
+             << "    max    " << setw(10) << ns(_histogram.max()) << " ns\n"
+             << endl;
+    }
+
+}  // namespace
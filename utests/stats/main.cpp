@@ -0,0 +1,123 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_messages = uint64_t{10'000'000};
+
+// local tests
+
+namespace {
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> int64_t;
+
+    void print(const char* _side, const tx_counters_t& _counters);
+
+    template<uint64_t CAPACITY>
+    void report();
+
+}
+
+// main procedure
+//
+// Producer and consumer threads exchange 16 byte records through `tx_queue_sp_t` with the stats policy off and on:
+// ● the message rates tell the cost of the counters (a store to a line each side already owns)
+// ● the counters of the second run tell how undersized the queue is: failed transactions, index syncs, split
+//   copies and same-core yields per committed message
+
+auto main() -> int {
+    cout << "== Messages: " << k_messages << "\n\n";
+
+    report<4_KiB>();
+    report<64_KiB>();
+    report<1_MiB>();
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    template<typename QTYPE>
+    auto transmision(QTYPE& _queue) -> int64_t {
+        if (!_queue) {
+            return -1;
+        }
+
+        auto errors     = uint64_t{0};
+        auto start_time = high_resolution_clock::now();
+        auto consumer   = thread([&]() {
+            for (auto i = uint64_t{0}; i < k_messages;) {
+                auto tx     = tx_read_t(_queue);
+                auto [a, b] = tx.template read<uint64_t, uint64_t>();
+                if (tx) {
+                    errors += a != i || b != i * 3;
+                    ++i;
+                }
+            }
+        });
+
+        for (auto i = uint64_t{0}; i < k_messages;) {
+            if (auto tx = tx_write_t(_queue); tx.write(i, i * 3)) {
+                ++i;
+            }
+        }
+
+        consumer.join();
+        const auto end_time = high_resolution_clock::now();
+        return errors ? -1 : duration_cast<nanoseconds>(end_time - start_time).count();
+    }
+
+    void print(const char* _side, const tx_counters_t& _counters) {
+        const auto per_message = [&](uint64_t _value) { return (double)_value / (double)max<uint64_t>(_counters.committed, 1); };
+
+        cout << "    " << _side << " | committed " << setw(10) << _counters.committed << " | bytes " << setw(12) << _counters.bytes  //
+             << " | invalidated " << fixed << setprecision(3) << setw(8) << per_message(_counters.invalidated) << "/msg"           //
+             << " | syncs " << setw(6) << per_message(_counters.syncs) << "/msg"                                                  //
+             << " | wraps " << setw(6) << per_message(_counters.wraps) << "/msg"                                                  //
+             << " | yields " << setw(6) << per_message(_counters.yields) << "/msg\n";
+    }
+
+    template<uint64_t CAPACITY>
+    void report() {
+        auto off = make_unique<tx_queue_sp_t<tx_wait_yield_t, tx_layout_shadow_t, tx_stats_off_t>>(CAPACITY);
+        auto on  = make_unique<tx_queue_sp_t<tx_wait_yield_t, tx_layout_shadow_t, tx_stats_on_t>>(CAPACITY);
+
+        const auto off_ns = transmision(*off);
+        const auto on_ns  = transmision(*on);
+        if (off_ns < 0 || on_ns < 0) {
+            cout << "Error: transmission failed with a capacity of " << format_size(CAPACITY) << "\n";
+            return;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_messages * 1e3 / (double)_ns; };  // millions of messages per second
+
+        cout << "  capacity " << setw(12) << format_size(CAPACITY)                             //
+             << " | off " << fixed << setprecision(2) << setw(8) << rate(off_ns) << " Mmsg/s"  //
+             << " | on " << setw(8) << rate(on_ns) << " Mmsg/s"                                //
+             << " | overhead " << ((double)on_ns / (double)off_ns - 1.0) * 100.0 << "%\n";
+
+        const auto stats = on->stats();
+        print("producer", stats.producer);
+        print("consumer", stats.consumer);
+    }
+
+}  // namespace
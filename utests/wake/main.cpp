@@ -0,0 +1,133 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "shared-memory.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_queue_size = (uint64_t)4_KiB;
+constexpr auto k_asleep     = 500ms;  // time given to the sleeper to get into the futex before the other side attaches
+constexpr auto k_deadline   = 5s;     // of the sleeper, only reached if the commit does not wake it
+constexpr auto k_max_wake   = 1s;     // from the commit to the wake-up
+constexpr auto k_value      = uint64_t{0x5eed'cafe};
+constexpr auto k_segment    = L"9c4d2e7a1b3f4a6c8e0d2b4f6a8c0e1d";
+
+// local types and tests
+
+namespace {
+
+    using mp_queue_t = tx_queue_mp_t<tx_wait_futex_t>;
+
+    constexpr auto k_memory_size = sizeof(mp_queue_t::status_t) + k_queue_size;
+
+    auto sleeper(shared_memory& _memory) -> int;
+    auto attacher() -> int;
+
+}
+
+// main procedure
+//
+// A consumer sleeps in `read_wait` on a `tx_queue_mp_t` with `tx_wait_futex_t` when the producer constructs its own
+// queue on the same memory, then commits. Attaching must not touch the status the consumer sleeps on: it has to wake
+// up with the commit, not with its deadline
+//
+// usage:
+// ● wake          two threads of this process, each with its own mapping of the segment
+// ● wake sleep    the consumer process (start it first), it creates the segment
+// ● wake attach   the producer process
+
+auto main(int _argc, const char* _argv[]) -> int {
+    const auto role = _argc > 1 ? string_view(_argv[1]) : string_view{};
+    if (role == "attach") {
+        return attacher();
+    }
+    if (!role.empty() && role != "sleep") {
+        cout << "usage: wake [sleep|attach]\n";
+        return -1;
+    }
+
+    auto memory = shared_memory(k_segment, k_memory_size);
+    if (!*memory) {
+        cout << "Error: could not create the shared memory\n";
+        return -1;
+    }
+
+    if (role == "sleep") {
+        return sleeper(memory);
+    }
+
+    auto result = 0;
+    auto other  = thread([&]() { result = attacher(); });
+    const auto slept = sleeper(memory);
+    other.join();
+    return slept ? slept : result;
+}
+
+namespace {
+
+    auto sleeper(shared_memory& _memory) -> int {
+        auto queue = mp_queue_t((uint8_t*)*_memory, k_memory_size);
+        if (!queue) {
+            cout << "Error: cannot initialize the queue\n";
+            return -1;
+        }
+
+        cout << "== Sleeping in read_wait...\n";
+        const auto t0    = steady_clock::now();
+        const auto ready = read_wait(queue, sizeof(uint64_t), t0 + k_deadline);
+        const auto slept = steady_clock::now() - t0;
+
+        auto value = uint64_t{0};
+        if (auto tx = tx_read_t(queue); !ready || !tx.read(value) || value != k_value) {
+            cout << "Error: no data after " << duration_cast<milliseconds>(slept).count() << " ms\n";
+            return -1;
+        }
+        if (slept > k_asleep + k_max_wake) {
+            cout << "Error: woken up after " << duration_cast<milliseconds>(slept).count() << " ms, not by the commit\n";
+            return -1;
+        }
+        cout << "  woken up after " << duration_cast<milliseconds>(slept).count() << " ms\n";
+        return 0;
+    }
+
+    auto attacher() -> int {
+        // open the segment once the sleeper has had the time to get asleep
+
+        this_thread::sleep_for(k_asleep);
+        auto memory = unique_ptr<shared_memory>{};
+        for (const auto t0 = steady_clock::now(); (!memory || !**memory) && (steady_clock::now() - t0) < 10s;) {
+            memory = make_unique<shared_memory>(k_segment);
+            if (!**memory) {
+                this_thread::sleep_for(100ms);
+            }
+        }
+        if (!**memory) {
+            cout << "Error: could not open the shared memory\n";
+            return -1;
+        }
+
+        auto queue = mp_queue_t((uint8_t*)**memory, k_memory_size);
+        if (auto tx = tx_write_t(queue); !queue || !tx.write(k_value)) {
+            cout << "Error: cannot write\n";
+            return -1;
+        }
+        return 0;
+    }
+
+}  // namespace
@@ -0,0 +1,170 @@
+// Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+// us
+
+#include "misc.h"
+#include "tx-queue.h"
+
+// C++
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace chrono;
+using namespace qcstudio;
+
+// constants
+
+constexpr auto k_jobs       = uint64_t{1'000'000};
+constexpr auto k_queue_size = (uint64_t)256_KiB;
+
+// local tests
+
+namespace {
+
+    auto work_queue(uint32_t _workers) -> int64_t;
+    auto dispatcher(uint32_t _workers) -> int64_t;
+    auto process(uint64_t _job) -> uint64_t;
+
+}
+
+// main procedure
+//
+// One producer hands out jobs of uneven cost (1 in 8 is 20 times heavier) to N worker threads:
+// ● work queue: one `tx_queue_spmc_t`, idle workers claim the next job
+// ● dispatcher: one `tx_queue_sp_t` per worker, the producer writes round-robin and skips the full ones
+
+auto main() -> int {
+    cout << "== Jobs: " << k_jobs << ", queue size: " << format_size(k_queue_size) << "\n\n";
+
+    const auto max_workers = max(2u, thread::hardware_concurrency()) - 1;
+    for (auto workers = 1u; workers <= max_workers; workers *= 2) {
+        const auto work_queue_ns = work_queue(workers);
+        const auto dispatcher_ns = dispatcher(workers);
+        if (work_queue_ns < 0 || dispatcher_ns < 0) {
+            cout << "Error: processing failed with " << workers << " workers\n";
+            continue;
+        }
+
+        const auto rate = [](int64_t _ns) { return (double)k_jobs * 1e3 / (double)_ns; };  // millions of jobs per second
+
+        cout << "  workers " << setw(2) << workers                                                            //
+             << " | work queue " << fixed << setprecision(2) << setw(8) << rate(work_queue_ns) << " Mjobs/s"  //
+             << " | dispatcher " << setw(8) << rate(dispatcher_ns) << " Mjobs/s"                              //
+             << " | speedup x" << (double)dispatcher_ns / (double)work_queue_ns << "\n";
+    }
+
+    cout << endl;
+    return 0;
+}
+
+namespace {
+
+    auto work_queue(uint32_t _workers) -> int64_t {
+        auto queue = tx_queue_spmc_t(k_queue_size);
+        if (!queue) {
+            return -1;
+        }
+
+        auto done       = atomic<uint64_t>{0};
+        auto checksum   = atomic<uint64_t>{0};
+        auto workers    = vector<thread>{};
+        auto start_time = high_resolution_clock::now();
+        for (auto w = 0u; w < _workers; ++w) {
+            workers.emplace_back([&]() {
+                auto local = uint64_t{0};
+                while (done.load(memory_order_relaxed) < k_jobs) {
+                    auto tx  = tx_read_t(queue);
+                    auto job = uint64_t{};
+                    if (tx.read(job)) {
+                        local += process(job);
+                        done.fetch_add(1, memory_order_relaxed);
+                    }
+                }
+                checksum.fetch_add(local);
+            });
+        }
+
+        for (auto i = uint64_t{0}; i < k_jobs;) {
+            if (auto tx = tx_write_t(queue); tx.write(i)) {
+                ++i;
+            }
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        auto expected = uint64_t{0};
+        for (auto i = uint64_t{0}; i < k_jobs; ++i) {
+            expected += process(i);
+        }
+        return checksum == expected ? duration_cast<nanoseconds>(end_time - start_time).count() : -1;
+    }
+
+    auto dispatcher(uint32_t _workers) -> int64_t {
+        auto queues = vector<unique_ptr<tx_queue_sp_t<>>>{};
+        for (auto w = 0u; w < _workers; ++w) {
+            queues.push_back(make_unique<tx_queue_sp_t<>>(k_queue_size / _workers));
+            if (!*queues.back()) {
+                return -1;
+            }
+        }
+
+        auto done       = atomic<uint64_t>{0};
+        auto checksum   = atomic<uint64_t>{0};
+        auto workers    = vector<thread>{};
+        auto start_time = high_resolution_clock::now();
+        for (auto w = 0u; w < _workers; ++w) {
+            workers.emplace_back([&, &queue = *queues[w]]() {
+                auto local = uint64_t{0};
+                while (done.load(memory_order_relaxed) < k_jobs) {
+                    auto tx  = tx_read_t(queue);
+                    auto job = uint64_t{};
+                    if (tx.read(job)) {
+                        local += process(job);
+                        done.fetch_add(1, memory_order_relaxed);
+                    }
+                }
+                checksum.fetch_add(local);
+            });
+        }
+
+        for (auto i = uint64_t{0}, next = uint64_t{0}; i < k_jobs; ++next) {
+            if (auto tx = tx_write_t(*queues[next % _workers]); tx.write(i)) {
+                ++i;
+            }
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const auto end_time = high_resolution_clock::now();
+
+        auto expected = uint64_t{0};
+        for (auto i = uint64_t{0}; i < k_jobs; ++i) {
+            expected += process(i);
+        }
+        return checksum == expected ? duration_cast<nanoseconds>(end_time - start_time).count() : -1;
+    }
+
+    auto process(uint64_t _job) -> uint64_t {
+        // a dependent chain, so the cost is not optimized away (heavy jobs are spread pseudo-randomly)
+
+        const auto heavy  = ((_job * 0x9E37'79B9'7F4A'7C15ull) >> 61) == 0;
+        auto       result = _job;
+        for (auto i = heavy ? 2000 : 100; i; --i) {
+            result = result * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        return result;
+    }
+
+}  // namespace
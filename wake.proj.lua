@@ -0,0 +1,5 @@
+﻿-- Copyright © 2017-2025 Raúl Ramos García. All rights reserved.
+
+project "wake"
+    kind      "ConsoleApp"
+    files     { "utests/wake/*", "utests/common/*.h", "utests/common/*.inl", "utests/common/*.cpp", "include/*.h", "include/*.inl" }